@@ -41,11 +41,15 @@ namespace gui
         editorKnobs(utils),
 
         bypassed(false),
-        shadr(utils, *this)
+        shadr(utils, *this),
 
+        meterInterest(p.meters.interest)
     {
         setComponentEffect(&shadr);
 
+        // the meters start from silence whenever the editor comes back
+        meterInterest.setActive(true);
+
         setMouseCursor(makeCursor(CursorType::Default));
 
         layout.init
@@ -97,6 +101,11 @@ namespace gui
         setComponentEffect(nullptr);
     }
 
+    void Editor::visibilityChanged()
+    {
+        meterInterest.setActive(isVisible());
+    }
+
     void Editor::paint(Graphics& g)
     {
         g.fillAll(Colours::c(ColourID::Bg));
@@ -28,6 +28,8 @@ namespace gui
         void mouseUp(const Mouse&) override;
         void mouseWheelMove(const Mouse&, const MouseWheel&) override;
 
+        void visibilityChanged() override;
+
         audio::Processor& audioProcessor;
     
 protected:
@@ -54,6 +56,8 @@ protected:
         bool bypassed;
         Shader shadr;
 
+        audio::Interest::Registration meterInterest;
+
         JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(Editor)
         //JUCE_LEAK_DETECTOR(Editor)
         //JUCE_HEAVYWEIGHT_LEAK_DETECTOR(Editor)
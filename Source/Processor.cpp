@@ -24,7 +24,9 @@ namespace audio
 
     ProcessorBackEnd::ProcessorBackEnd() :
         juce::AudioProcessor(makeBusesProperties()),
-        props(),
+        settings(),
+        props(settings->props),
+        arena(),
         sus(*this),
         state(),
         xenManager(),
@@ -53,12 +55,14 @@ namespace audio
             options.commonToAllUsers = false;
             options.ignoreCaseOfKeyNames = false;
             options.doNotSave = false;
-            options.millisecondsBeforeSaving = 20;
             options.storageFormat = juce::PropertiesFile::storeAsXML;
 
-            props.setStorageParameters(options);
+            settings->init(options);
         }
 
+        // picks the kernels off the audio thread
+        dispatch::get();
+
         startTimerHz(6);
     }
 
@@ -89,21 +93,21 @@ namespace audio
 
     bool ProcessorBackEnd::isBusesLayoutSupported(const BusesLayout& layouts) const
     {
-        const auto mono = ChannelSet::mono();
-        const auto stereo = ChannelSet::stereo();
-        
         const auto mainIn = layouts.getMainInputChannelSet();
         const auto mainOut = layouts.getMainOutputChannelSet();
 
         if (mainIn != mainOut)
             return false;
 
-        if (mainOut != stereo && mainOut != mono)
+        // any layout works, all channels share the lanes' coefficients
+        if (mainOut.isDisabled())
             return false;
 
 #if PPDHasSidechain
         if (wrapperType != wrapperType_Standalone)
         {
+            const auto mono = ChannelSet::mono();
+            const auto stereo = ChannelSet::stereo();
             const auto scIn = layouts.getChannelSet(true, 1);
             if (!scIn.isDisabled())
                 if (scIn != stereo && scIn != mono)
@@ -120,7 +124,7 @@ namespace audio
 
     void ProcessorBackEnd::savePatch()
     {
-        params.savePatch(props);
+        params.savePatch();
         midiManager.savePatch();
         tuningEditorSynth.savePatch(state);
     }
@@ -142,7 +146,7 @@ namespace audio
         sus.suspend();
     }
 
-    void ProcessorBackEnd::timerCallback()
+    bool ProcessorBackEnd::isPrepareNeeded()
     {
         bool shallForcePrepare = false;
 #if PPDHasHQ
@@ -155,8 +159,12 @@ namespace audio
 		if (lookaheadEnabled != _lookaheadEnabled)
 			shallForcePrepare = true;
 #endif
+        return shallForcePrepare;
+    }
 
-        if (shallForcePrepare)
+    void ProcessorBackEnd::timerCallback()
+    {
+        if (isPrepareNeeded())
 			forcePrepareToPlay();
     }
 
@@ -173,63 +181,113 @@ namespace audio
         if (numSamples == 0)
             return;
 
-        auto samples = mainBuffer.getArrayOfWritePointers();
-        const auto constSamples = mainBuffer.getArrayOfReadPointers();
         const auto numChannels = mainBuffer.getNumChannels();
 
-        dryWetMix.processBypass(samples, numChannels, numSamples);
+        for (auto s = 0; s < numSamples; s += SubBlockSize)
+        {
+            const auto numSamplesSub = std::min(SubBlockSize, numSamples - s);
+            AudioBuffer subBuffer(mainBuffer.getArrayOfWritePointers(), numChannels, s, numSamplesSub);
+            auto samples = subBuffer.getArrayOfWritePointers();
+            const auto constSamples = subBuffer.getArrayOfReadPointers();
+
+            dryWetMix.processBypass(samples, numChannels, numSamplesSub);
 #if PPDHasGainIn
-        meters.processIn(constSamples, numChannels, numSamples);
+            meters.processIn(constSamples, numChannels, numSamplesSub);
 #endif
-        meters.processOut(constSamples, numChannels, numSamples);
+            meters.processOut(constSamples, numChannels, numSamplesSub);
+        }
+
+        sus.processFade(mainBuffer);
     }
 
     // PROCESSOR
 
     Processor::Processor() :
         ProcessorBackEnd(),
+        channelLink(),
         manta(xenManager),
-        spectroBeam()
+        spectroBeam(xenManager),
+        stateCacheLock(),
+        stateCache(),
+        stateCacheGeneration(0)
     {
         auto& gainParam = *params[PID::Gain];
         gainParam.setValueWithGesture(gainParam.range.convertTo0to1(17.f));
     }
 
+    Processor::~Processor()
+    {
+        sus.stop();
+    }
+
     void Processor::prepareToPlay(double sampleRate, int maxBlockSize)
     {
+        const juce::ScopedLock lock(sus.getPrepareLock());
+
+        const auto numChannels = std::max(1, getMainBusNumInputChannels());
+        const auto numChannelsTotal = std::max(1, getTotalNumInputChannels());
+
+        // measure the most demanding mode once, so that mode toggles only re-slice the arena
+        if (!arena.fits(sampleRate, maxBlockSize, numChannelsTotal))
+        {
+            arena.beginMeasure();
+            prepareEngine(sampleRate, maxBlockSize, numChannels, true);
+            arena.endMeasure(sampleRate, maxBlockSize, numChannelsTotal);
+        }
+
+        arena.reset();
+        const auto latency = prepareEngine(sampleRate, maxBlockSize, numChannels, false);
+
+        // decided after the real configuration, so that the measure pass doesn't start and stop threads.
+        // off unless the user opts in, since every instance would get its own workers
+        manta.updateWorkers(props.getUserSettings()->getBoolValue("laneThreads", false));
+
+        setLatencySamples(latency);
+
+        sus.prepareToPlay();
+    }
+
+    int Processor::prepareEngine(double sampleRate, int maxBlockSize, int numChannels, bool worstCase)
+    {
+        juce::ignoreUnused(worstCase);
+
+        const auto blockSize = std::min(maxBlockSize, SubBlockSize);
+
         auto latency = 0;
         auto sampleRateUp = sampleRate;
-        auto blockSizeUp = maxBlockSize;
+        auto blockSizeUp = blockSize;
 #if PPDHasHQ
-        oversampler.setEnabled(params[PID::HQ]->getValMod() > .5f);
-        oversampler.prepare(sampleRate, maxBlockSize);
+        oversampler.setEnabled(worstCase || params[PID::HQ]->getValMod() > .5f);
+        oversampler.prepare(arena, sampleRate, blockSize, std::max(1, getTotalNumInputChannels()));
         sampleRateUp = oversampler.getFsUp();
         blockSizeUp = oversampler.getBlockSizeUp();
         latency = oversampler.getLatency();
 #endif
 		
 #if PPDHasLookahead
-        lookaheadEnabled = params[PID::Lookahead]->getValMod() > .5f;
+        lookaheadEnabled = worstCase || params[PID::Lookahead]->getValMod() > .5f;
 #endif
         const auto sampleRateUpF = static_cast<float>(sampleRateUp);
         const auto sampleRateF = static_cast<float>(sampleRate);
 
-        midiVoices.prepare(blockSizeUp);
-		tuningEditorSynth.prepare(sampleRateF, maxBlockSize);
+        // midi is still handled per host block
+        midiVoices.prepare(maxBlockSize);
+		tuningEditorSynth.prepare(arena, sampleRateF, blockSize);
 
-        manta.prepare(sampleRateUpF, blockSizeUp);
-        spectroBeam.prepare(maxBlockSize);
+        channelLink.prepare();
+        manta.prepare(arena, sampleRateUpF, numChannels, blockSizeUp);
+        spectroBeam.prepare(arena, sampleRateF, blockSize);
 #if PPDHasLookahead
         latency += lookaheadEnabled ? manta.delaySize / 2 : 0;
 #endif
 
-        dryWetMix.prepare(sampleRateF, maxBlockSize, latency);
+        dryWetMix.prepare(arena, sampleRateF, numChannels, blockSize, latency);
 
-        meters.prepare(sampleRateF, maxBlockSize);
+        meters.prepare(arena, sampleRateF, blockSize);
 
-        setLatencySamples(latency);
+        sus.prepare(arena, numChannels, maxBlockSize);
 
-        sus.prepareToPlay();
+        return latency;
     }
 
     void Processor::processBlock(AudioBuffer& buffer, juce::MidiBuffer& midi)
@@ -262,9 +320,39 @@ namespace audio
         if (params[PID::Power]->getValMod() < .5f)
             return processBlockBypassed(buffer, midi);
 
+        for (auto s = 0; s < numSamples; s += SubBlockSize)
+        {
+            AudioBuffer subBuffer(buffer.getArrayOfWritePointers(), buffer.getNumChannels(), s, std::min(SubBlockSize, numSamples - s));
+            processSubBlock(subBuffer);
+        }
+
+        sus.processFade(mainBuffer);
+
+#if JUCE_DEBUG
+        for (auto ch = 0; ch < mainBuffer.getNumChannels(); ++ch)
+        {
+            auto smpls = mainBuffer.getWritePointer(ch);
+
+            for (auto s = 0; s < numSamples; ++s)
+            {
+                if (smpls[s] > 2.f)
+                    smpls[s] = 2.f;
+                else if (smpls[s] < -2.f)
+                    smpls[s] = -2.f;
+            }
+        }
+#endif
+    }
+
+    void Processor::processSubBlock(AudioBuffer& buffer)
+    {
+        auto mainBus = getBus(true, 0);
+        auto mainBuffer = mainBus->getBusBuffer(buffer);
+
         const auto samples = mainBuffer.getArrayOfWritePointers();
         const auto constSamples = mainBuffer.getArrayOfReadPointers();
         const auto numChannels = mainBuffer.getNumChannels();
+        const auto numSamples = mainBuffer.getNumSamples();
 
 #if PPD_MixOrGainDry
         bool muteDry = params[PID::MuteDry]->getValMod() > .5f;
@@ -306,10 +394,22 @@ namespace audio
         }
 
 #endif
-        processBlockDownsampled(samples, numChannels, numSamples);
+#if PPDHasSidechain
+        const auto numChannelsWet = numChannels;
+#else
+        const auto numChannelsWet = channelLink(constSamples, numChannels, numSamples);
+        if (channelLink.isUnlinking())
+        {
+            manta.copyFirstChannelState();
+#if PPDHasHQ
+            oversampler.copyFirstChannelState();
+#endif
+        }
+#endif
+        processBlockDownsampled(samples, numChannelsWet, numSamples);
 
 #if PPDHasHQ
-        auto resampledBuf = &oversampler.upsample(buffer);
+        auto resampledBuf = &oversampler.upsample(buffer, buffer.getNumChannels() - numChannels + numChannelsWet);
 #else
         auto resampledBuf = &buffer;
 #endif
@@ -342,13 +442,16 @@ namespace audio
         processBlockUpsampled
         (
             resampledMainBuf.getArrayOfWritePointers(),
-            resampledMainBuf.getNumChannels(),
+            numChannelsWet,
             resampledMainBuf.getNumSamples()
         );
 #endif
 
 #if PPDHasHQ
-        oversampler.downsample(mainBuffer);
+        oversampler.downsample(mainBuffer, numChannelsWet);
+#endif
+#if !PPDHasSidechain
+        channelLink.processWet(samples, numChannels, numSamples);
 #endif
 
 #if PPDHasStereoConfig
@@ -367,8 +470,7 @@ namespace audio
             if (isClipping)
             {
                 for (auto ch = 0; ch < numChannels; ++ch)
-                    for (auto s = 0; s < numSamples; ++s)
-                        samples[ch][s] = softclip(samples[ch][s], .6f);
+                    math::softclip(samples[ch], numSamples, .6f);
             }
         }
         meters.processOut(constSamples, numChannels, numSamples);
@@ -384,21 +486,6 @@ namespace audio
             , params[PID::Delta]->getValMod() > .5f
 #endif
         );
-
-#if JUCE_DEBUG
-        for (auto ch = 0; ch < numChannels; ++ch)
-        {
-            auto smpls = samples[ch];
-
-            for (auto s = 0; s < numSamples; ++s)
-            {
-                if (smpls[s] > 2.f)
-                    smpls[s] = 2.f;
-                else if (smpls[s] < -2.f)
-                    smpls[s] = -2.f;
-            }
-        }
-#endif
     }
 
     void Processor::processBlockDownsampled(float* const* samples, int numChannels, int numSamples
@@ -514,8 +601,16 @@ namespace audio
     /////////////////////////////////////////////;
     void Processor::getStateInformation(juce::MemoryBlock& destData)
     {
-        savePatch();
-        state.savePatch(*this, destData);
+        const juce::ScopedLock lock(stateCacheLock);
+        // hosts ask for the state all the time, but it only needs to be serialized again after a change
+        const auto generation = state.getGeneration();
+        if (generation != stateCacheGeneration)
+        {
+            savePatch();
+            state.savePatch(*this, stateCache);
+            stateCacheGeneration = generation;
+        }
+        destData = stateCache;
     }
 
     void Processor::setStateInformation(const void* data, int sizeInBytes)
@@ -526,6 +621,7 @@ namespace audio
 
     void Processor::savePatch()
     {
+        const State::ScopedSerialization serializing(state);
         ProcessorBackEnd::savePatch();
         manta.savePatch(state);
     }
@@ -533,8 +629,11 @@ namespace audio
     void Processor::loadPatch()
     {
         ProcessorBackEnd::loadPatch();
+        // parameters glide through their smoothers and the wavetables get published whole,
+        // so only a different engine configuration needs to rebuild it
         manta.loadPatch(state);
-        forcePrepareToPlay();
+        if (isPrepareNeeded())
+            forcePrepareToPlay();
     }
 }
 
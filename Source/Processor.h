@@ -3,12 +3,15 @@
 #include <juce_audio_processors/juce_audio_processors.h>
 #include <juce_events/juce_events.h>
 
+#include "arch/Settings.h"
 #include "audio/XenManager.h"
 #include "audio/MIDIManager.h"
 #include "audio/MIDILearn.h"
+#include "audio/Arena.h"
 #include "audio/ProcessSuspend.h"
 #include "audio/DryWetMix.h"
 #include "audio/MidSide.h"
+#include "audio/ChannelLink.h"
 #include "audio/Oversampling.h"
 #include "audio/Meter.h"
 
@@ -29,6 +32,9 @@ namespace audio
         using ChannelSet = juce::AudioChannelSet;
         using AppProps = juce::ApplicationProperties;
 
+        // the engine processes host blocks in chunks of this size, so that its working set stays in cache
+        static constexpr int SubBlockSize = 128;
+
         ProcessorBackEnd();
 
         const juce::String getName() const override;
@@ -52,7 +58,9 @@ namespace audio
 
         juce::AudioProcessor::BusesProperties makeBusesProperties();
 
-        AppProps props;
+        juce::SharedResourcePointer<sta::Settings> settings;
+        AppProps& props;
+        Arena arena;
         ProcessSuspender sus;
 
         XenManager xenManager;
@@ -70,6 +78,9 @@ namespace audio
 
         void forcePrepareToPlay();
 
+        /* true if the parameters ask for another configuration of the engine (HQ, lookahead) */
+        bool isPrepareNeeded();
+
         void timerCallback() override;
 
         void processBlockBypassed(AudioBuffer&, juce::MidiBuffer&) override;
@@ -89,9 +100,17 @@ namespace audio
     {
         Processor();
 
+        ~Processor() override;
+
         void prepareToPlay(double, int) override;
 
+        /* sampleRate, maxBlockSize, numChannels, worstCase. returns the latency */
+        int prepareEngine(double, int, int, bool);
+
         void processBlock(AudioBuffer&, juce::MidiBuffer&);
+
+        /* buffer (SubBlockSize samples max) */
+        void processSubBlock(AudioBuffer&);
         
         /* samples, numChannels, numSamples, samplesSC, numChannelsSC */
         void processBlockDownsampled(float* const*, int numChannels, int numSamples
@@ -121,7 +140,13 @@ namespace audio
 
         juce::AudioProcessorEditor* createEditor() override;
 
+        ChannelLink channelLink;
         Manta manta;
         SpectroBeam<11> spectroBeam;
+    protected:
+        juce::CriticalSection stateCacheLock;
+        juce::MemoryBlock stateCache;
+        // generation of the state when the cache was serialized
+        juce::uint32 stateCacheGeneration;
     };
 }
@@ -0,0 +1,295 @@
+#include "Dispatch.h"
+
+#if JUCE_INTEL
+#include <immintrin.h>
+#if JUCE_MSVC
+#define DispatchTarget(isa)
+#else
+#define DispatchTarget(isa) __attribute__((target(isa)))
+#endif
+#elif JUCE_ARM && JUCE_64BIT
+#include <arm_neon.h>
+#endif
+
+namespace dispatch
+{
+	String toString(ISA isa)
+	{
+		switch (isa)
+		{
+		case ISA::Scalar: return "Scalar";
+		case ISA::SSE2: return "SSE2";
+		case ISA::AVX2: return "AVX2";
+		case ISA::AVX512: return "AVX-512";
+		case ISA::NEON: return "NEON";
+		default: return "Invalid ISA";
+		}
+	}
+
+	// SCALAR
+
+	float dotScalar(const float* a, const float* b, int size) noexcept
+	{
+		auto y = 0.f;
+		for (auto i = 0; i < size; ++i)
+			y += a[i] * b[i];
+		return y;
+	}
+
+	float sumOfSquaresScalar(const float* smpls, int size) noexcept
+	{
+		auto y = 0.f;
+		for (auto i = 0; i < size; ++i)
+			y += smpls[i] * smpls[i];
+		return y;
+	}
+
+	void rampScalar(float* dest, float startVal, float inc, int size) noexcept
+	{
+		for (auto i = 0; i < size; ++i)
+			dest[i] = startVal + inc * static_cast<float>(i);
+	}
+
+#if JUCE_INTEL
+	// SSE2
+
+	float hsum(__m128 x) noexcept
+	{
+		const auto hi = _mm_movehl_ps(x, x);
+		const auto sum2 = _mm_add_ps(x, hi);
+		const auto sum1 = _mm_add_ss(sum2, _mm_shuffle_ps(sum2, sum2, 1));
+		return _mm_cvtss_f32(sum1);
+	}
+
+	float dotSSE2(const float* a, const float* b, int size) noexcept
+	{
+		auto acc = _mm_setzero_ps();
+		auto i = 0;
+		for (; i + 4 <= size; i += 4)
+			acc = _mm_add_ps(acc, _mm_mul_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+		auto y = hsum(acc);
+		for (; i < size; ++i)
+			y += a[i] * b[i];
+		return y;
+	}
+
+	float sumOfSquaresSSE2(const float* smpls, int size) noexcept
+	{
+		auto acc = _mm_setzero_ps();
+		auto i = 0;
+		for (; i + 4 <= size; i += 4)
+		{
+			const auto x = _mm_loadu_ps(smpls + i);
+			acc = _mm_add_ps(acc, _mm_mul_ps(x, x));
+		}
+		auto y = hsum(acc);
+		for (; i < size; ++i)
+			y += smpls[i] * smpls[i];
+		return y;
+	}
+
+	void rampSSE2(float* dest, float startVal, float inc, int size) noexcept
+	{
+		auto x = _mm_add_ps(_mm_set1_ps(startVal), _mm_mul_ps(_mm_set1_ps(inc), _mm_setr_ps(0.f, 1.f, 2.f, 3.f)));
+		const auto step = _mm_set1_ps(inc * 4.f);
+		auto i = 0;
+		for (; i + 4 <= size; i += 4, x = _mm_add_ps(x, step))
+			_mm_storeu_ps(dest + i, x);
+		for (; i < size; ++i)
+			dest[i] = startVal + inc * static_cast<float>(i);
+	}
+
+	// AVX2
+
+	DispatchTarget("avx2,fma")
+	float hsum(__m256 x) noexcept
+	{
+		const auto sum4 = _mm_add_ps(_mm256_castps256_ps128(x), _mm256_extractf128_ps(x, 1));
+		const auto hi = _mm_movehl_ps(sum4, sum4);
+		const auto sum2 = _mm_add_ps(sum4, hi);
+		const auto sum1 = _mm_add_ss(sum2, _mm_shuffle_ps(sum2, sum2, 1));
+		return _mm_cvtss_f32(sum1);
+	}
+
+	DispatchTarget("avx2,fma")
+	float dotAVX2(const float* a, const float* b, int size) noexcept
+	{
+		auto acc0 = _mm256_setzero_ps();
+		auto acc1 = _mm256_setzero_ps();
+		auto i = 0;
+		for (; i + 16 <= size; i += 16)
+		{
+			acc0 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i), acc0);
+			acc1 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i + 8), _mm256_loadu_ps(b + i + 8), acc1);
+		}
+		for (; i + 8 <= size; i += 8)
+			acc0 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i), acc0);
+		auto y = hsum(_mm256_add_ps(acc0, acc1));
+		for (; i < size; ++i)
+			y += a[i] * b[i];
+		return y;
+	}
+
+	DispatchTarget("avx2,fma")
+	float sumOfSquaresAVX2(const float* smpls, int size) noexcept
+	{
+		auto acc = _mm256_setzero_ps();
+		auto i = 0;
+		for (; i + 8 <= size; i += 8)
+		{
+			const auto x = _mm256_loadu_ps(smpls + i);
+			acc = _mm256_fmadd_ps(x, x, acc);
+		}
+		auto y = hsum(acc);
+		for (; i < size; ++i)
+			y += smpls[i] * smpls[i];
+		return y;
+	}
+
+	DispatchTarget("avx2,fma")
+	void rampAVX2(float* dest, float startVal, float inc, int size) noexcept
+	{
+		const auto idx = _mm256_setr_ps(0.f, 1.f, 2.f, 3.f, 4.f, 5.f, 6.f, 7.f);
+		auto x = _mm256_fmadd_ps(_mm256_set1_ps(inc), idx, _mm256_set1_ps(startVal));
+		const auto step = _mm256_set1_ps(inc * 8.f);
+		auto i = 0;
+		for (; i + 8 <= size; i += 8, x = _mm256_add_ps(x, step))
+			_mm256_storeu_ps(dest + i, x);
+		for (; i < size; ++i)
+			dest[i] = startVal + inc * static_cast<float>(i);
+	}
+
+	// AVX-512
+
+	DispatchTarget("avx512f")
+	float dotAVX512(const float* a, const float* b, int size) noexcept
+	{
+		auto acc = _mm512_setzero_ps();
+		auto i = 0;
+		for (; i + 16 <= size; i += 16)
+			acc = _mm512_fmadd_ps(_mm512_loadu_ps(a + i), _mm512_loadu_ps(b + i), acc);
+		const auto rest = size - i;
+		if (rest != 0)
+		{
+			const auto mask = static_cast<__mmask16>((1u << rest) - 1u);
+			acc = _mm512_fmadd_ps(_mm512_maskz_loadu_ps(mask, a + i), _mm512_maskz_loadu_ps(mask, b + i), acc);
+		}
+		return _mm512_reduce_add_ps(acc);
+	}
+
+	DispatchTarget("avx512f")
+	float sumOfSquaresAVX512(const float* smpls, int size) noexcept
+	{
+		auto acc = _mm512_setzero_ps();
+		auto i = 0;
+		for (; i + 16 <= size; i += 16)
+		{
+			const auto x = _mm512_loadu_ps(smpls + i);
+			acc = _mm512_fmadd_ps(x, x, acc);
+		}
+		const auto rest = size - i;
+		if (rest != 0)
+		{
+			const auto mask = static_cast<__mmask16>((1u << rest) - 1u);
+			const auto x = _mm512_maskz_loadu_ps(mask, smpls + i);
+			acc = _mm512_fmadd_ps(x, x, acc);
+		}
+		return _mm512_reduce_add_ps(acc);
+	}
+
+	DispatchTarget("avx512f")
+	void rampAVX512(float* dest, float startVal, float inc, int size) noexcept
+	{
+		const auto idx = _mm512_setr_ps(0.f, 1.f, 2.f, 3.f, 4.f, 5.f, 6.f, 7.f,
+			8.f, 9.f, 10.f, 11.f, 12.f, 13.f, 14.f, 15.f);
+		auto x = _mm512_fmadd_ps(_mm512_set1_ps(inc), idx, _mm512_set1_ps(startVal));
+		const auto step = _mm512_set1_ps(inc * 16.f);
+		auto i = 0;
+		for (; i + 16 <= size; i += 16, x = _mm512_add_ps(x, step))
+			_mm512_storeu_ps(dest + i, x);
+		const auto rest = size - i;
+		if (rest != 0)
+			_mm512_mask_storeu_ps(dest + i, static_cast<__mmask16>((1u << rest) - 1u), x);
+	}
+#elif JUCE_ARM && JUCE_64BIT
+	// NEON
+
+	float dotNEON(const float* a, const float* b, int size) noexcept
+	{
+		auto acc = vdupq_n_f32(0.f);
+		auto i = 0;
+		for (; i + 4 <= size; i += 4)
+			acc = vfmaq_f32(acc, vld1q_f32(a + i), vld1q_f32(b + i));
+		auto y = vaddvq_f32(acc);
+		for (; i < size; ++i)
+			y += a[i] * b[i];
+		return y;
+	}
+
+	float sumOfSquaresNEON(const float* smpls, int size) noexcept
+	{
+		auto acc = vdupq_n_f32(0.f);
+		auto i = 0;
+		for (; i + 4 <= size; i += 4)
+		{
+			const auto x = vld1q_f32(smpls + i);
+			acc = vfmaq_f32(acc, x, x);
+		}
+		auto y = vaddvq_f32(acc);
+		for (; i < size; ++i)
+			y += smpls[i] * smpls[i];
+		return y;
+	}
+
+	void rampNEON(float* dest, float startVal, float inc, int size) noexcept
+	{
+		const float idx[] = { 0.f, 1.f, 2.f, 3.f };
+		auto x = vfmaq_f32(vdupq_n_f32(startVal), vdupq_n_f32(inc), vld1q_f32(idx));
+		const auto step = vdupq_n_f32(inc * 4.f);
+		auto i = 0;
+		for (; i + 4 <= size; i += 4, x = vaddq_f32(x, step))
+			vst1q_f32(dest + i, x);
+		for (; i < size; ++i)
+			dest[i] = startVal + inc * static_cast<float>(i);
+	}
+#endif
+
+	// DISPATCH
+
+	ISA detectISA() noexcept
+	{
+#if JUCE_INTEL
+		using Stats = juce::SystemStats;
+		if (Stats::hasAVX512F())
+			return ISA::AVX512;
+		if (Stats::hasAVX2() && Stats::hasFMA3())
+			return ISA::AVX2;
+		if (Stats::hasSSE2())
+			return ISA::SSE2;
+#elif JUCE_ARM && JUCE_64BIT
+		return ISA::NEON;
+#endif
+		return ISA::Scalar;
+	}
+
+	Kernels makeKernels(ISA isa) noexcept
+	{
+		switch (isa)
+		{
+#if JUCE_INTEL
+		case ISA::SSE2: return { isa, &dotSSE2, &sumOfSquaresSSE2, &rampSSE2 };
+		case ISA::AVX2: return { isa, &dotAVX2, &sumOfSquaresAVX2, &rampAVX2 };
+		case ISA::AVX512: return { isa, &dotAVX512, &sumOfSquaresAVX512, &rampAVX512 };
+#elif JUCE_ARM && JUCE_64BIT
+		case ISA::NEON: return { isa, &dotNEON, &sumOfSquaresNEON, &rampNEON };
+#endif
+		default: return { ISA::Scalar, &dotScalar, &sumOfSquaresScalar, &rampScalar };
+		}
+	}
+
+	const Kernels& get() noexcept
+	{
+		static const Kernels kernels = makeKernels(detectISA());
+		return kernels;
+	}
+}
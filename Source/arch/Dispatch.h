@@ -0,0 +1,49 @@
+#pragma once
+#include <juce_core/juce_core.h>
+
+/*
+* runtime cpu dispatch for the hot dsp kernels.
+* every kernel is compiled for each instruction set the architecture supports,
+* the best one is picked once via cpuid and stays fixed for the lifetime of the binary.
+*/
+
+namespace dispatch
+{
+	using String = juce::String;
+
+	enum class ISA
+	{
+		Scalar,
+		SSE2,
+		AVX2,
+		AVX512,
+		NEON,
+		NumISAs
+	};
+
+	String toString(ISA);
+
+	/* a, b, size */
+	using DotFunc = float(*)(const float*, const float*, int) noexcept;
+	/* smpls, size */
+	using SumOfSquaresFunc = float(*)(const float*, int) noexcept;
+	/* dest, startVal, inc, size */
+	using RampFunc = void(*)(float*, float, float, int) noexcept;
+
+	struct Kernels
+	{
+		ISA isa;
+		DotFunc dot;
+		SumOfSquaresFunc sumOfSquares;
+		RampFunc ramp;
+	};
+
+	/* best isa supported by this cpu and binary */
+	ISA detectISA() noexcept;
+
+	/* the kernel table for the detected isa. call once off the audio thread to initialize */
+	const Kernels& get() noexcept;
+
+	/* the kernel table for a specific isa, falls back to scalar if it is not compiled in */
+	Kernels makeKernels(ISA) noexcept;
+}
@@ -0,0 +1,177 @@
+#include "PatchBank.h"
+#include "PatchIndex.h"
+
+namespace sta
+{
+	PatchBank::PatchBank() :
+		mapped(),
+		data(nullptr),
+		size(0),
+		numPatches(0)
+	{
+	}
+
+	bool PatchBank::open(const File& file)
+	{
+		close();
+
+		mapped = std::make_unique<juce::MemoryMappedFile>(file, juce::MemoryMappedFile::readOnly);
+		const auto d = static_cast<const char*>(mapped->getData());
+		const auto s = mapped->getSize();
+		if (d == nullptr || s < HeaderSize
+			|| static_cast<int>(juce::ByteOrder::littleEndianInt(d)) != BankMagic
+			|| static_cast<int>(juce::ByteOrder::littleEndianInt(d + 4)) != BankVersion)
+		{
+			close();
+			return false;
+		}
+
+		const auto num = static_cast<int>(juce::ByteOrder::littleEndianInt(d + 8));
+		if (num < 0 || HeaderSize + static_cast<size_t>(num) * EntrySize > s)
+		{
+			close();
+			return false;
+		}
+
+		data = d;
+		size = s;
+		numPatches = num;
+		return true;
+	}
+
+	void PatchBank::close()
+	{
+		mapped.reset();
+		data = nullptr;
+		size = 0;
+		numPatches = 0;
+	}
+
+	int PatchBank::getNumPatches() const noexcept
+	{
+		return numPatches;
+	}
+
+	PatchBank::Info PatchBank::getInfo(int idx) const
+	{
+		int metaSize, treeSize;
+		const auto record = getRecord(idx, metaSize, treeSize);
+		if (record == nullptr)
+			return {};
+
+		juce::MemoryInputStream meta(record, static_cast<size_t>(metaSize), false);
+		Info info;
+		info.name = meta.readString();
+		info.author = meta.readString();
+		info.tags = meta.readString();
+		return info;
+	}
+
+	juce::ValueTree PatchBank::getPatch(int idx) const
+	{
+		int metaSize, treeSize;
+		const auto record = getRecord(idx, metaSize, treeSize);
+		if (record == nullptr)
+			return {};
+
+		return ValueTree::readFromData(record + metaSize, static_cast<size_t>(treeSize));
+	}
+
+	int PatchBank::extract(const File& directory) const
+	{
+		auto numFiles = 0;
+		for (auto i = 0; i < numPatches; ++i)
+		{
+			const auto patch = getPatch(i);
+			if (!patch.isValid())
+				continue;
+
+			const auto info = getInfo(i);
+			const auto file = directory.getChildFile(PatchIndex::getFileName(info.name, info.author));
+			if (file.replaceWithText(patch.toXmlString()))
+				++numFiles;
+		}
+		return numFiles;
+	}
+
+	int PatchBank::create(const File& bankFile, const juce::Array<File>& patchFiles)
+	{
+		struct Entry
+		{
+			juce::int64 offset;
+			int metaSize, treeSize;
+		};
+
+		std::vector<Entry> entries;
+		juce::MemoryOutputStream records;
+
+		for (const auto& file : patchFiles)
+		{
+			const auto xml = juce::XmlDocument::parse(file);
+			if (xml == nullptr)
+				continue;
+			const auto patch = ValueTree::fromXml(*xml);
+			if (!patch.isValid())
+				continue;
+
+			String name, author;
+			PatchIndex::parseFileName(file.getFileNameWithoutExtension(), name, author);
+
+			const auto start = records.getPosition();
+			records.writeString(name);
+			records.writeString(author);
+			records.writeString(patch.getProperty("tags").toString());
+			const auto treeStart = records.getPosition();
+			patch.writeToStream(records);
+			const auto end = records.getPosition();
+
+			entries.push_back({ start, static_cast<int>(treeStart - start), static_cast<int>(end - treeStart) });
+		}
+
+		const auto num = static_cast<int>(entries.size());
+		// the records come after the header and the entries
+		const auto recordsOffset = static_cast<juce::int64>(HeaderSize + entries.size() * EntrySize);
+
+		// nothing reads the bank before it is complete
+		juce::TemporaryFile temp(bankFile);
+		{
+			juce::FileOutputStream stream(temp.getFile());
+			if (!stream.openedOk())
+				return -1;
+
+			stream.writeInt(BankMagic);
+			stream.writeInt(BankVersion);
+			stream.writeInt(num);
+			stream.writeInt(0);
+			for (const auto& entry : entries)
+			{
+				stream.writeInt64(recordsOffset + entry.offset);
+				stream.writeInt(entry.metaSize);
+				stream.writeInt(entry.treeSize);
+			}
+			stream.write(records.getData(), records.getDataSize());
+			stream.flush();
+			if (stream.getStatus().failed())
+				return -1;
+		}
+		if (!temp.overwriteTargetFileWithTemporary())
+			return -1;
+		return num;
+	}
+
+	const char* PatchBank::getRecord(int idx, int& metaSize, int& treeSize) const noexcept
+	{
+		if (idx < 0 || idx >= numPatches)
+			return nullptr;
+
+		const auto entry = data + HeaderSize + static_cast<size_t>(idx) * EntrySize;
+		const auto offset = static_cast<juce::uint64>(juce::ByteOrder::littleEndianInt64(entry));
+		metaSize = static_cast<int>(juce::ByteOrder::littleEndianInt(entry + 8));
+		treeSize = static_cast<int>(juce::ByteOrder::littleEndianInt(entry + 12));
+
+		if (metaSize < 0 || treeSize < 0
+			|| offset + static_cast<juce::uint64>(metaSize) + static_cast<juce::uint64>(treeSize) > size)
+			return nullptr;
+		return data + offset;
+	}
+}
@@ -0,0 +1,64 @@
+#pragma once
+#include <juce_core/juce_core.h>
+#include <juce_data_structures/juce_data_structures.h>
+#include <memory>
+#include <vector>
+
+namespace sta
+{
+	/*
+	* many patches in one file, which is mapped into memory instead of being read.
+	* a header and a table of fixed size entries come first, so finding a patch is a pointer lookup.
+	* each record holds name, author and tags, followed by the value tree of the patch in juce's binary format.
+	* banks are made from patch files and can be turned back into patch files.
+	*/
+	struct PatchBank
+	{
+		using String = juce::String;
+		using File = juce::File;
+		using ValueTree = juce::ValueTree;
+
+		// "MPBK", little endian
+		static constexpr int BankMagic = 0x4b42504d;
+		static constexpr int BankVersion = 1;
+		// magic, version, numPatches, reserved
+		static constexpr size_t HeaderSize = 16;
+		// offset (64 bit), metaSize, treeSize
+		static constexpr size_t EntrySize = 16;
+
+		struct Info
+		{
+			String name, author, tags;
+		};
+
+		PatchBank();
+
+		/* file. maps the bank into memory, returns false if it is not a bank */
+		bool open(const File&);
+
+		void close();
+
+		int getNumPatches() const noexcept;
+
+		/* idx */
+		Info getInfo(int) const;
+
+		/* idx. decodes the patch, invalid if the record is broken */
+		ValueTree getPatch(int) const;
+
+		/* directory. writes each patch of the bank into directory as a patch file. returns the number of files */
+		int extract(const File&) const;
+
+		/* bank, patchFiles. writes the patch files into a new bank. returns the number of patches in it, -1 if it couldn't be written */
+		static int create(const File&, const juce::Array<File>&);
+
+	protected:
+		std::unique_ptr<juce::MemoryMappedFile> mapped;
+		const char* data;
+		size_t size;
+		int numPatches;
+
+		/* idx, metaSize, treeSize. returns the beginning of the record, nullptr if it doesn't fit into the file */
+		const char* getRecord(int, int&, int&) const noexcept;
+	};
+}
@@ -0,0 +1,266 @@
+#include "PatchIndex.h"
+#include "PatchBank.h"
+
+namespace sta
+{
+	PatchIndex::PatchIndex() :
+		thread("Manta Patch Index"),
+		lock(),
+		ready(),
+		directory(),
+		indexFile(),
+		cache(),
+		entries(),
+		stale(),
+		staleIdx(0),
+		scanning(false),
+		listed(false),
+		changed(false)
+	{
+	}
+
+	PatchIndex::~PatchIndex()
+	{
+		thread.removeTimeSliceClient(this);
+		thread.stopThread(1000);
+	}
+
+	void PatchIndex::scan(const File& _directory, const File& _indexFile)
+	{
+		thread.removeTimeSliceClient(this);
+
+		directory = _directory;
+		indexFile = _indexFile;
+		cache.clear();
+		entries.clear();
+		stale.clear();
+		staleIdx = 0;
+		listed = false;
+		changed = false;
+		{
+			const juce::ScopedLock sl(lock);
+			ready.clear();
+		}
+		scanning.store(true);
+
+		thread.addTimeSliceClient(this);
+		if (!thread.isThreadRunning())
+			thread.startThread(juce::Thread::Priority::background);
+	}
+
+	bool PatchIndex::pull(std::vector<Entry>& dest, size_t maxNum)
+	{
+		const juce::ScopedLock sl(lock);
+		const auto num = std::min(maxNum, ready.size());
+		if (num == 0)
+			return false;
+
+		for (auto i = static_cast<size_t>(0); i < num; ++i)
+			dest.push_back(std::move(ready[i]));
+		ready.erase(ready.begin(), ready.begin() + num);
+		return true;
+	}
+
+	bool PatchIndex::isScanning() const noexcept
+	{
+		if (scanning.load())
+			return true;
+		const juce::ScopedLock sl(lock);
+		return !ready.empty();
+	}
+
+	int PatchIndex::useTimeSlice()
+	{
+		if (!listed)
+		{
+			list();
+			listed = true;
+			return 0;
+		}
+
+		const auto end = std::min(staleIdx + BatchSize, stale.size());
+		const auto start = staleIdx;
+		for (; staleIdx < end; ++staleIdx)
+		{
+			auto& s = stale[staleIdx];
+			s = read(s.file, s.mtime);
+		}
+		publish(stale.data() + start, end - start);
+
+		if (staleIdx < stale.size())
+			return 0;
+
+		entries.insert(entries.end(), stale.begin(), stale.end());
+		if (changed)
+			writeIndex();
+		stale.clear();
+		cache.clear();
+		scanning.store(false);
+		return -1;
+	}
+
+	PatchIndex::Entry PatchIndex::read(const File& file, juce::int64 mtime)
+	{
+		Entry entry{ file, {}, {}, {}, mtime, -1 };
+		parseFileName(file.getFileNameWithoutExtension(), entry.name, entry.author);
+
+		// only the attributes of the root are needed, so the rest of the patch is never read
+		std::unique_ptr<juce::XmlElement> xml;
+		{
+			juce::FileInputStream stream(file);
+			if (stream.openedOk())
+			{
+				juce::MemoryBlock head;
+				stream.readIntoMemoryBlock(head, HeadSize);
+				juce::XmlDocument doc(head.toString());
+				xml = doc.getDocumentElement(true);
+			}
+		}
+		if (xml == nullptr)
+			xml = juce::XmlDocument(file).getDocumentElement(true);
+
+		if (xml != nullptr)
+			entry.tags = xml->getStringAttribute("tags");
+		return entry;
+	}
+
+	void PatchIndex::parseFileName(const String& fileName, String& name, String& author)
+	{
+		for (auto i = 0; i < fileName.length(); ++i)
+		{
+			const auto chr = fileName[i];
+			if (chr == '_')
+				if (fileName.substring(i, i + 3) == "_-_")
+				{
+					author = fileName.substring(0, i);
+					name = fileName.substring(i + 3);
+				}
+		}
+	}
+
+	juce::String PatchIndex::getFileName(const String& name, const String& author)
+	{
+		return author + "_-_" + name + ".patch";
+	}
+
+	void PatchIndex::publish(const Entry* e, size_t num)
+	{
+		if (num == 0)
+			return;
+		const juce::ScopedLock sl(lock);
+		ready.insert(ready.end(), e, e + num);
+	}
+
+	void PatchIndex::readIndex()
+	{
+		juce::FileInputStream stream(indexFile);
+		if (!stream.openedOk())
+			return;
+		if (stream.readInt() != IndexMagic || stream.readInt() != IndexVersion)
+			return;
+
+		const auto numEntries = stream.readInt();
+		for (auto i = 0; i < numEntries && !stream.isExhausted(); ++i)
+		{
+			const auto path = stream.readString();
+			Entry entry;
+			entry.file = directory.getChildFile(path);
+			entry.mtime = stream.readInt64();
+			entry.name = stream.readString();
+			entry.author = stream.readString();
+			entry.tags = stream.readString();
+			entry.bankIdx = -1;
+			cache[path] = std::move(entry);
+		}
+	}
+
+	void PatchIndex::writeIndex() const
+	{
+		// other instances may read the index while it is written, so it only gets replaced when complete
+		juce::TemporaryFile temp(indexFile);
+		{
+			juce::FileOutputStream stream(temp.getFile());
+			if (!stream.openedOk())
+				return;
+
+			stream.writeInt(IndexMagic);
+			stream.writeInt(IndexVersion);
+			stream.writeInt(static_cast<int>(entries.size()));
+			for (const auto& entry : entries)
+			{
+				stream.writeString(entry.file.getRelativePathFrom(directory));
+				stream.writeInt64(entry.mtime);
+				stream.writeString(entry.name);
+				stream.writeString(entry.author);
+				stream.writeString(entry.tags);
+			}
+			stream.flush();
+			if (stream.getStatus().failed())
+				return;
+		}
+		temp.overwriteTargetFileWithTemporary();
+	}
+
+	void PatchIndex::list()
+	{
+		readIndex();
+
+		const juce::RangedDirectoryIterator files
+		(
+			directory,
+			true,
+			"*.patch",
+			File::TypesOfFileToFind::findFiles
+		);
+
+		auto numKnown = static_cast<size_t>(0);
+		for (const auto& it : files)
+		{
+			const auto& file = it.getFile();
+			const auto mtime = it.getModificationTime().toMilliseconds();
+			const auto known = cache.find(file.getRelativePathFrom(directory));
+			if (known != cache.end() && known->second.mtime == mtime)
+			{
+				entries.push_back(known->second);
+				++numKnown;
+			}
+			else
+				stale.push_back({ file, {}, {}, {}, mtime, -1 });
+		}
+
+		// also true if patches were deleted since the index was written
+		changed = !stale.empty() || numKnown != cache.size();
+
+		publish(entries.data(), entries.size());
+		listBanks();
+	}
+
+	void PatchIndex::listBanks()
+	{
+		const juce::RangedDirectoryIterator files
+		(
+			directory,
+			true,
+			"*.patchbank",
+			File::TypesOfFileToFind::findFiles
+		);
+
+		std::vector<Entry> bankEntries;
+		PatchBank bank;
+		for (const auto& it : files)
+		{
+			const auto& file = it.getFile();
+			if (!bank.open(file))
+				continue;
+
+			const auto mtime = it.getModificationTime().toMilliseconds();
+			for (auto i = 0; i < bank.getNumPatches(); ++i)
+			{
+				auto info = bank.getInfo(i);
+				bankEntries.push_back({ file, std::move(info.name), std::move(info.author), std::move(info.tags), mtime, i });
+			}
+		}
+
+		publish(bankEntries.data(), bankEntries.size());
+	}
+}
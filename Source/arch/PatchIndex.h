@@ -0,0 +1,90 @@
+#pragma once
+#include <juce_core/juce_core.h>
+#include <juce_events/juce_events.h>
+#include <atomic>
+#include <unordered_map>
+#include <vector>
+
+namespace sta
+{
+	/*
+	* finds the patches of a directory on a background thread.
+	* what it learns about a patch (name, author, tags) is kept in one index file next to the patches,
+	* together with the modification time of the file. when scanning again only the patches whose
+	* time changed get read, everything else comes from the index.
+	* the entries are handed out in the order they got known, so the browser can show them while they arrive.
+	* patch banks are listed as well, their own table of contents is cheap enough to not need the index.
+	*/
+	struct PatchIndex :
+		public juce::TimeSliceClient
+	{
+		using String = juce::String;
+		using File = juce::File;
+
+		// "PIDX", little endian
+		static constexpr int IndexMagic = 0x58444950;
+		static constexpr int IndexVersion = 1;
+		// patches read per time slice
+		static constexpr int BatchSize = 32;
+		// most patches don't have any root attributes beyond this
+		static constexpr int HeadSize = 1 << 12;
+
+		struct Entry
+		{
+			File file;
+			String name, author, tags;
+			juce::int64 mtime;
+			// record of the patch in the bank file, -1 if file is a patch file
+			int bankIdx;
+		};
+
+		PatchIndex();
+
+		~PatchIndex() override;
+
+		/* directory, indexFile. starts indexing the patches of directory. message thread */
+		void scan(const File&, const File&);
+
+		/* dest, maxNum. moves up to maxNum of the entries found since the last call to the end of dest */
+		bool pull(std::vector<Entry>&, size_t);
+
+		/* true until the last entry of the scan was pulled. message thread */
+		bool isScanning() const noexcept;
+
+		/* background thread */
+		int useTimeSlice() override;
+
+		/* file, mtime. name and author from the file name, tags from the root of the patch */
+		static Entry read(const File&, juce::int64);
+
+		/* fileName, name, author. for instance: user_-_best patch ever */
+		static void parseFileName(const String&, String&, String&);
+
+		/* name, author */
+		static String getFileName(const String&, const String&);
+
+	protected:
+		juce::TimeSliceThread thread;
+		juce::CriticalSection lock;
+		std::vector<Entry> ready;
+		File directory, indexFile;
+		std::unordered_map<String, Entry> cache;
+		std::vector<Entry> entries, stale;
+		size_t staleIdx;
+		std::atomic<bool> scanning;
+		bool listed, changed;
+
+		/* entries */
+		void publish(const Entry*, size_t);
+
+		void readIndex();
+
+		void writeIndex() const;
+
+		/* lists the directory and publishes what the index still knows */
+		void list();
+
+		/* publishes the patches of the banks in the directory */
+		void listBanks();
+	};
+}
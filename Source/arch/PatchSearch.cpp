@@ -0,0 +1,238 @@
+#include "PatchSearch.h"
+
+namespace sta
+{
+	PatchSearch::PatchSearch() :
+		results(),
+		thread("Manta Patch Search"),
+		lock(),
+		newDocs(),
+		removedIDs(),
+		newQuery(),
+		newQueryIdx(0),
+		queryChanged(false),
+		nextID(0),
+		docs(),
+		postings(),
+		queryGrams(),
+		hits(),
+		touched(),
+		candidates(),
+		ranked(),
+		text(),
+		wordText(),
+		queryIdx(0),
+		candidateIdx(0),
+		stage(Stage::Idle)
+	{
+		thread.addTimeSliceClient(this);
+		thread.startThread(juce::Thread::Priority::background);
+	}
+
+	PatchSearch::~PatchSearch()
+	{
+		thread.removeTimeSliceClient(this);
+		thread.stopThread(1000);
+	}
+
+	int PatchSearch::add(const String& name, const String& author, const String& tags)
+	{
+		const juce::ScopedLock sl(lock);
+		newDocs.push_back({ name.toLowerCase(), author.toLowerCase(), tags.toLowerCase(), false });
+		return nextID++;
+	}
+
+	void PatchSearch::remove(int id)
+	{
+		const juce::ScopedLock sl(lock);
+		removedIDs.push_back(id);
+	}
+
+	juce::uint32 PatchSearch::query(const String& txt)
+	{
+		juce::uint32 idx;
+		{
+			const juce::ScopedLock sl(lock);
+			newQuery = txt.trim().toLowerCase();
+			queryChanged = true;
+			idx = ++newQueryIdx;
+		}
+		thread.moveToFrontOfQueue(this);
+		return idx;
+	}
+
+	int PatchSearch::useTimeSlice()
+	{
+		// patches that arrive while a query runs should show up in its results
+		if (sync() && text.isNotEmpty())
+			stage = Stage::Collect;
+
+		switch (stage)
+		{
+		case Stage::Collect:
+			collect();
+			return 0;
+		case Stage::Rank:
+			rank();
+			return 0;
+		default:
+			return IdleIntervalMs;
+		}
+	}
+
+	template<typename Func>
+	void PatchSearch::forEachGram(const String& str, Func&& onGram)
+	{
+		// 3 code points of 21 bits each
+		static constexpr juce::uint64 Mask = (static_cast<juce::uint64>(1) << 63) - 1;
+
+		juce::uint64 gram = 0;
+		auto num = 0;
+		for (auto p = str.getCharPointer(); !p.isEmpty();)
+		{
+			gram = ((gram << 21) | static_cast<juce::uint64>(p.getAndAdvance())) & Mask;
+			if (++num >= 3)
+				onGram(gram);
+		}
+	}
+
+	bool PatchSearch::sync()
+	{
+		std::vector<Doc> added;
+		std::vector<int> removed;
+		{
+			const juce::ScopedLock sl(lock);
+			added.swap(newDocs);
+			removed.swap(removedIDs);
+			if (queryChanged)
+			{
+				text = newQuery;
+				queryIdx = newQueryIdx;
+				queryChanged = false;
+				stage = text.isEmpty() ? Stage::Idle : Stage::Collect;
+			}
+		}
+
+		for (auto& doc : added)
+		{
+			docs.push_back(std::move(doc));
+			index(static_cast<int>(docs.size()) - 1);
+		}
+		for (const auto id : removed)
+			docs[id].removed = true;
+
+		return !added.empty() || !removed.empty();
+	}
+
+	void PatchSearch::index(int id)
+	{
+		const auto& doc = docs[id];
+		const auto onGram = [&](juce::uint64 gram)
+		{
+			auto& list = postings[gram];
+			if (list.empty() || list.back() != id)
+				list.push_back(id);
+		};
+		// padded, so that the beginnings and ends of the fields have trigrams, too
+		forEachGram("  " + doc.name + " ", onGram);
+		forEachGram("  " + doc.author + " ", onGram);
+		forEachGram("  " + doc.tags + " ", onGram);
+	}
+
+	void PatchSearch::collect()
+	{
+		wordText = " " + text;
+		queryGrams.clear();
+		forEachGram(text, [&](juce::uint64 gram)
+		{
+			if (std::find(queryGrams.begin(), queryGrams.end(), gram) == queryGrams.end())
+				queryGrams.push_back(gram);
+		});
+
+		candidates.clear();
+		ranked.clear();
+		candidateIdx = 0;
+		stage = Stage::Rank;
+
+		// queries shorter than a trigram are only matched exactly
+		if (queryGrams.empty())
+		{
+			for (auto id = 0; id < docs.size(); ++id)
+				if (!docs[id].removed)
+					candidates.push_back({ 0.f, id });
+			return;
+		}
+
+		hits.assign(docs.size(), 0);
+		touched.clear();
+		for (const auto gram : queryGrams)
+		{
+			const auto list = postings.find(gram);
+			if (list != postings.end())
+				for (const auto id : list->second)
+					if (hits[id]++ == 0)
+						touched.push_back(id);
+		}
+
+		// a typo costs up to 3 trigrams, so half of them is enough to be considered
+		const auto minHits = (static_cast<int>(queryGrams.size()) + 1) / 2;
+		for (const auto id : touched)
+			if (!docs[id].removed && hits[id] >= minHits)
+				candidates.push_back({ 0.f, id });
+	}
+
+	void PatchSearch::rank()
+	{
+		const auto end = std::min(candidateIdx + BatchSize, candidates.size());
+		for (; candidateIdx < end; ++candidateIdx)
+		{
+			auto candidate = candidates[candidateIdx];
+			const auto numHits = queryGrams.empty() ? 0 : hits[candidate.id];
+			candidate.score = score(docs[candidate.id], numHits);
+			if (candidate.score > 0.f)
+				ranked.push_back(candidate);
+		}
+
+		std::sort(ranked.begin(), ranked.end(), [](const Candidate& a, const Candidate& b)
+		{
+			if (a.score != b.score)
+				return a.score > b.score;
+			return a.id < b.id;
+		});
+
+		const auto complete = candidateIdx == candidates.size();
+		publish(complete);
+		if (complete)
+			stage = Stage::Idle;
+	}
+
+	float PatchSearch::score(const Doc& doc, int numHits) const
+	{
+		auto s = queryGrams.empty() ? 0.f : static_cast<float>(numHits) / static_cast<float>(queryGrams.size());
+
+		if (doc.name.startsWith(text))
+			s += 4.f;
+		else if (doc.name.contains(wordText))
+			s += 3.f;
+		else if (doc.name.contains(text))
+			s += 2.f;
+
+		if (doc.author.contains(text))
+			s += 1.f;
+		if (doc.tags.contains(text))
+			s += 1.f;
+
+		return s;
+	}
+
+	void PatchSearch::publish(bool complete)
+	{
+		auto& result = results.getWriteBuffer();
+		result.ids.clear();
+		for (const auto& candidate : ranked)
+			result.ids.push_back(candidate.id);
+		result.queryIdx = queryIdx;
+		result.complete = complete;
+		results.publish();
+	}
+}
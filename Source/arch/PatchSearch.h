@@ -0,0 +1,113 @@
+#pragma once
+#include "TripleBuffer.h"
+#include <juce_core/juce_core.h>
+#include <juce_events/juce_events.h>
+#include <algorithm>
+#include <unordered_map>
+#include <vector>
+
+namespace sta
+{
+	/*
+	* search as you type over the names, authors and tags of the patches.
+	* every patch is a document whose trigrams point back at it, so a query only looks at the
+	* documents that share trigrams with it. candidates are ranked by the share of the query's trigrams
+	* they contain, which tolerates typos, and by where the query matches exactly (name prefix first).
+	* queries run on a background thread, which publishes the ranking after each batch of candidates,
+	* so the best matches show up before the whole library was ranked.
+	*/
+	struct PatchSearch :
+		public juce::TimeSliceClient
+	{
+		using String = juce::String;
+
+		// candidates scored per time slice before the ranking is published
+		static constexpr size_t BatchSize = 1 << 11;
+		static constexpr int IdleIntervalMs = 50;
+
+		struct Result
+		{
+			// document ids, best match first
+			std::vector<int> ids;
+			juce::uint32 queryIdx;
+			bool complete;
+		};
+
+		PatchSearch();
+
+		~PatchSearch() override;
+
+		/* name, author, tags. returns the id of the new document. message thread */
+		int add(const String&, const String&, const String&);
+
+		/* id. message thread */
+		void remove(int);
+
+		/* text. returns the index that the results of this query will carry. message thread */
+		juce::uint32 query(const String&);
+
+		/* background thread */
+		int useTimeSlice() override;
+
+		// read by the browser
+		threads::TripleBuffer<Result> results;
+
+	protected:
+		struct Doc
+		{
+			String name, author, tags;
+			bool removed;
+		};
+
+		struct Candidate
+		{
+			float score;
+			int id;
+		};
+
+		enum class Stage { Idle, Collect, Rank };
+
+		juce::TimeSliceThread thread;
+		// written by the message thread, taken over by the background thread
+		juce::CriticalSection lock;
+		std::vector<Doc> newDocs;
+		std::vector<int> removedIDs;
+		String newQuery;
+		juce::uint32 newQueryIdx;
+		bool queryChanged;
+		int nextID;
+
+		// background thread only
+		std::vector<Doc> docs;
+		std::unordered_map<juce::uint64, std::vector<int>> postings;
+		std::vector<juce::uint64> queryGrams;
+		std::vector<int> hits, touched;
+		std::vector<Candidate> candidates, ranked;
+		// the query and the query as the beginning of a word
+		String text, wordText;
+		juce::uint32 queryIdx;
+		size_t candidateIdx;
+		Stage stage;
+
+		/* str, onGram. calls onGram with each trigram of str */
+		template<typename Func>
+		static void forEachGram(const String&, Func&&);
+
+		/* takes over what the message thread changed. returns true if the documents changed */
+		bool sync();
+
+		/* id */
+		void index(int);
+
+		/* finds the documents that share trigrams with the query */
+		void collect();
+
+		/* scores the next batch of candidates and publishes the ranking so far */
+		void rank();
+
+		/* doc, numHits */
+		float score(const Doc&, int) const;
+
+		void publish(bool);
+	};
+}
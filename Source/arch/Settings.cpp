@@ -0,0 +1,40 @@
+#include "Settings.h"
+
+namespace sta
+{
+	Settings::Settings() :
+		props(),
+		thread("Manta Settings"),
+		user(nullptr)
+	{
+	}
+
+	Settings::~Settings()
+	{
+		thread.removeTimeSliceClient(this);
+		thread.stopThread(1000);
+		if (user != nullptr)
+			user->saveIfNeeded();
+	}
+
+	void Settings::init(juce::PropertiesFile::Options options)
+	{
+		if (user != nullptr)
+			return;
+
+		options.millisecondsBeforeSaving = -1;
+		props.setStorageParameters(options);
+		// opened here, so that the background thread never has to create it
+		user = props.getUserSettings();
+
+		thread.addTimeSliceClient(this);
+		thread.startThread(juce::Thread::Priority::background);
+	}
+
+	int Settings::useTimeSlice()
+	{
+		if (user->needsToBeSaved())
+			user->saveIfNeeded();
+		return SaveIntervalMs;
+	}
+}
@@ -0,0 +1,33 @@
+#pragma once
+#include <juce_data_structures/juce_data_structures.h>
+#include <juce_events/juce_events.h>
+
+namespace sta
+{
+	/*
+	* the user settings file, shared by all instances of the plugin in a process.
+	* hold it with a juce::SharedResourcePointer, so that instances don't overwrite each other's changes.
+	* changes only mark the file as dirty. a background thread writes it at most once per SaveIntervalMs,
+	* so neither the message thread nor host state queries ever wait for the disk.
+	*/
+	struct Settings :
+		public juce::TimeSliceClient
+	{
+		static constexpr int SaveIntervalMs = 1000;
+
+		Settings();
+
+		~Settings() override;
+
+		/* options. only the first call has an effect, saving is always left to the background thread */
+		void init(juce::PropertiesFile::Options);
+
+		/* background thread */
+		int useTimeSlice() override;
+
+		juce::ApplicationProperties props;
+	protected:
+		juce::TimeSliceThread thread;
+		juce::PropertiesFile* user;
+	};
+}
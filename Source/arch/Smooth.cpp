@@ -1,5 +1,7 @@
 #include "Smooth.h"
+#include "Dispatch.h"
 #include <cmath>
+#include <type_traits>
 #include <juce_audio_basics/juce_audio_basics.h>
 
 namespace smooth
@@ -41,11 +43,17 @@ namespace smooth
 		const auto dist = val - curVal;
 		const auto inc = dist / static_cast<Float>(numSamples);
 		
-		for (auto s = 0; s < numSamples; ++s)
+		if constexpr (std::is_same_v<Float, float>)
 		{
-			buffer[s] = curVal;
-			curVal += inc;
+			dispatch::get().ramp(buffer, curVal, inc, numSamples);
+			curVal = val;
 		}
+		else
+			for (auto s = 0; s < numSamples; ++s)
+			{
+				buffer[s] = curVal;
+				curVal += inc;
+			}
 	}
 	
 	template<typename Float>
@@ -1,22 +1,119 @@
 #include "State.h"
 
+// ScopedSerialization
+
+sta::State::ScopedSerialization::ScopedSerialization(State& _state) :
+	state(_state)
+{
+	++state.numSerializing;
+}
+
+sta::State::ScopedSerialization::~ScopedSerialization()
+{
+	--state.numSerializing;
+}
+
+// Handle
+
+sta::State::Handle::Handle() :
+	path(),
+	id(),
+	node(),
+	treeIdx(0)
+{
+}
+
+sta::State::Handle::Handle(const String& key, const String& _id) :
+	path(),
+	id(toID(_id)),
+	node(),
+	treeIdx(0)
+{
+	const auto keyID = toID(key);
+	// the type of the root addresses the root itself
+	if (keyID == "state")
+		return;
+	for (const auto& name : juce::StringArray::fromTokens(keyID, "/", ""))
+		if (name.isNotEmpty())
+			path.emplace_back(name);
+}
+
+// State
+
 sta::State::State() :
 	state("state"),
-	undoer()
+	undoer(MaxUndoUnits, MinUndoTransactions),
+	lastUndoableNode(),
+	lastUndoableID(),
+	lastUndoableMs(0),
+	treeIdx(1),
+	generation(1),
+	numSerializing(0),
+	packedKey(),
+	packedColumns()
 {
+	state.addListener(this);
 }
 
 sta::State::State(const String& str) :
 	state("state"),
-	undoer()
+	undoer(MaxUndoUnits, MinUndoTransactions),
+	lastUndoableNode(),
+	lastUndoableID(),
+	lastUndoableMs(0),
+	treeIdx(1),
+	generation(1),
+	numSerializing(0),
+	packedKey(),
+	packedColumns()
 {
 	state = state.fromXml(str);
+	state.addListener(this);
+}
+
+sta::State::~State()
+{
+	state.removeListener(this);
+}
+
+void sta::State::markDirty() noexcept
+{
+	generation.fetch_add(1);
+}
+
+juce::uint32 sta::State::getGeneration() const noexcept
+{
+	return generation.load();
+}
+
+void sta::State::setPackedTable(const String& key, std::vector<juce::Identifier>&& columns)
+{
+	packedKey = toID(key);
+	packedColumns = std::move(columns);
 }
 
-void sta::State::savePatch(const Proc& p, juce::MemoryBlock& destData) const
+void sta::State::savePatch(const Proc&, juce::MemoryBlock& destData) const
 {
-	std::unique_ptr<juce::XmlElement> xml(state.createXml());
-	p.copyXmlToBinary(*xml, destData);
+	juce::MemoryOutputStream out(destData, false);
+	out.writeInt(ChunkMagic);
+	out.writeInt(ChunkVersion);
+
+	const auto numColumns = static_cast<int>(packedColumns.size());
+	std::vector<ValueTree> rows;
+	if (numColumns != 0)
+		for (const auto& row : state.getChildWithName(packedKey))
+			if (isPackable(row))
+				rows.push_back(row);
+
+	out.writeInt(static_cast<int>(rows.size()));
+	out.writeInt(numColumns);
+	for (const auto& row : rows)
+		for (const auto& column : packedColumns)
+			out.writeFloat(static_cast<float>(row.getProperty(column)));
+	for (const auto& row : rows)
+		out.writeString(row.getType().toString());
+
+	writeTree(out, state);
 }
 
 void sta::State::savePatch(juce::File& xmlFile) const
@@ -37,7 +134,8 @@ void sta::State::loadPatch(const XML& xmlState)
 
 void sta::State::loadPatch(const Proc& p, const void* data, int sizeInBytes)
 {
-	loadPatch(p.getXmlFromBinary(data, sizeInBytes));
+	if (!loadChunk(data, sizeInBytes))
+		loadPatch(p.getXmlFromBinary(data, sizeInBytes));
 }
 
 void sta::State::loadPatch(const char* data, int sizeInBytes)
@@ -58,75 +156,88 @@ void sta::State::loadPatch(const juce::File& xmlFile)
 void sta::State::loadPatch(const ValueTree& vt)
 {
 	state = vt;
+	// the history belongs to the previous tree
+	undoer.clearUndoHistory();
+	lastUndoableNode = {};
+	++treeIdx;
+	markDirty();
 }
 
 void sta::State::set(String&& key, String&& id, Var&& val, bool undoable)
 {
-	if (undoable)
-	{
-		undoer.beginNewTransaction();
-		setProperty(toID(key), toID(id), std::move(val), state, &undoer);
-	}
-	else
-		setProperty(toID(key), toID(id), std::move(val), state, nullptr);
+	set(Handle(key, id), std::move(val), undoable);
 }
 
 void sta::State::set(String&& key, const String& id, Var&& val, bool undoable)
 {
-	if (undoable)
-	{
-		undoer.beginNewTransaction();
-		setProperty(toID(key), toID(id), std::move(val), state, &undoer);
-	}
-	else
-		setProperty(toID(key), toID(id), std::move(val), state, nullptr);
+	set(Handle(key, id), std::move(val), undoable);
 }
 
 void sta::State::set(const String& key, String&& id, Var&& val, bool undoable)
 {
-	if (undoable)
-	{
-		undoer.beginNewTransaction();
-		setProperty(toID(key), toID(id), std::move(val), state, &undoer);
-	}
-	else
-		setProperty(toID(key), toID(id), std::move(val), state, nullptr);
+	set(Handle(key, id), std::move(val), undoable);
 }
 
 void sta::State::set(const String& key, const String& id, Var&& val, bool undoable)
 {
-	if (undoable)
+	set(Handle(key, id), std::move(val), undoable);
+}
+
+void sta::State::set(const Handle& handle, Var&& val, bool undoable)
+{
+	auto node = resolve(handle, true);
+
+	// the patch being serialized only mirrors values into the tree, that's nothing to undo
+	if (!undoable || numSerializing != 0)
 	{
-		undoer.beginNewTransaction();
-		setProperty(toID(key), toID(id), std::move(val), state, &undoer);
+		node.setProperty(handle.id, std::move(val), nullptr);
+		return;
 	}
-	else
-		setProperty(toID(key), toID(id), std::move(val), state, nullptr);
+
+	// a knob being dragged sets the same property over and over, that's one step to undo
+	const auto now = juce::Time::getMillisecondCounter();
+	if (node != lastUndoableNode || handle.id != lastUndoableID || now - lastUndoableMs > CoalesceMs)
+		undoer.beginNewTransaction();
+	lastUndoableNode = node;
+	lastUndoableID = handle.id;
+	lastUndoableMs = now;
+
+	node.setProperty(handle.id, std::move(val), &undoer);
+}
+
+const sta::State::Var* sta::State::get(const Handle& handle) const
+{
+	const auto node = resolve(handle, false);
+	if (!node.isValid())
+		return nullptr;
+	return node.getPropertyPointer(handle.id);
 }
 
 const sta::State::Var* sta::State::get(String&& key, String&& id) const
 {
-	return getProperty(key, toID(id), state);
+	return get(Handle(key, id));
 }
 
 const sta::State::Var* sta::State::get(String&& key, const String& id) const
 {
-	return getProperty(key, toID(id), state);
+	return get(Handle(key, id));
 }
 
 const sta::State::Var* sta::State::get(const String& key, const String& id) const
 {
-	return getProperty(key, toID(id), state);
+	return get(Handle(key, id));
 }
 
 void sta::State::undo()
 {
+	lastUndoableNode = {};
 	if (undoer.canUndo())
 		undoer.undo();
 }
 
 void sta::State::redo()
 {
+	lastUndoableNode = {};
 	if (undoer.canRedo())
 		undoer.redo();
 }
@@ -136,6 +247,109 @@ sta::State::ValueTree sta::State::getState() const noexcept
 	return state;
 }
 
+bool sta::State::isPackable(const ValueTree& row) const
+{
+	for (const auto& column : packedColumns)
+	{
+		const auto var = row.getPropertyPointer(column);
+		if (var == nullptr || !(var->isDouble() || var->isInt()))
+			return false;
+	}
+	return true;
+}
+
+void sta::State::writeTree(juce::OutputStream& out, const ValueTree& tree) const
+{
+	const auto isPackedTable = !packedColumns.empty() && tree.getType() == packedKey && tree.getParent() == state;
+
+	out.writeString(tree.getType().toString());
+	const auto numProperties = tree.getNumProperties();
+	out.writeCompressedInt(numProperties);
+	for (auto i = 0; i < numProperties; ++i)
+	{
+		const auto name = tree.getPropertyName(i);
+		out.writeString(name.toString());
+		tree.getProperty(name).writeToStream(out);
+	}
+
+	auto numChildren = 0;
+	for (const auto& child : tree)
+		if (!isPackedTable || !isPackable(child))
+			++numChildren;
+	out.writeCompressedInt(numChildren);
+	for (const auto& child : tree)
+		if (!isPackedTable || !isPackable(child))
+			writeTree(out, child);
+}
+
+bool sta::State::loadChunk(const void* data, int sizeInBytes)
+{
+	// the stream is only a view of the host's data
+	juce::MemoryInputStream in(data, static_cast<size_t>(sizeInBytes), false);
+	if (sizeInBytes < 16 || in.readInt() != ChunkMagic)
+		return false;
+	if (in.readInt() > ChunkVersion)
+		return false;
+
+	const auto numRows = in.readInt();
+	const auto numColumns = in.readInt();
+	const auto tablePos = in.getPosition();
+	const auto tableSize = static_cast<juce::int64>(numRows) * numColumns * sizeof(float);
+	if (numRows < 0 || numColumns != static_cast<int>(packedColumns.size()) || tableSize > in.getNumBytesRemaining())
+		return false;
+	in.skipNextBytes(tableSize);
+
+	std::vector<juce::Identifier> rowNames;
+	rowNames.reserve(numRows);
+	for (auto r = 0; r < numRows; ++r)
+	{
+		const auto name = in.readString();
+		if (name.isEmpty())
+			return false;
+		rowNames.emplace_back(name);
+	}
+
+	auto tree = ValueTree::readFromStream(in);
+	if (!tree.hasType(state.getType()))
+		return false;
+
+	if (numRows != 0)
+	{
+		in.setPosition(tablePos);
+		auto table = tree.getOrCreateChildWithName(packedKey, nullptr);
+		for (const auto& rowName : rowNames)
+		{
+			auto row = table.getOrCreateChildWithName(rowName, nullptr);
+			for (const auto& column : packedColumns)
+				row.setProperty(column, in.readFloat(), nullptr);
+		}
+	}
+
+	loadPatch(tree);
+	return true;
+}
+
+void sta::State::valueTreePropertyChanged(ValueTree&, const juce::Identifier&)
+{
+	treeChanged();
+}
+
+void sta::State::valueTreeChildAdded(ValueTree&, ValueTree&)
+{
+	treeChanged();
+}
+
+void sta::State::valueTreeChildRemoved(ValueTree&, ValueTree&, int)
+{
+	treeChanged();
+}
+
+void sta::State::treeChanged() noexcept
+{
+	if (numSerializing == 0)
+		markDirty();
+}
+
 // DEBUGGING:
 sta::State::String sta::State::toString() const { return state.toXmlString(); }
 
@@ -150,58 +364,31 @@ sta::State::String sta::State::toString(String&& key, String&& id) const
 		return var->toString();
 }
 
-sta::State::String sta::State::toID(const String& txt) const
+sta::State::String sta::State::toID(const String& txt)
 {
 	return txt.removeCharacters(" ").toLowerCase();
 }
 
-void sta::State::setProperty(const String& key, const String& id, Var&& val, ValueTree knot, Undo* mngr)
+sta::State::ValueTree sta::State::resolve(const Handle& handle, bool create) const
 {
-	if (knot.getType().toString() == key)
-		knot.setProperty(id, val, mngr);
-	else if (!key.contains("/"))
+	if (handle.treeIdx == treeIdx && handle.node.isValid())
+		return handle.node;
+
+	auto node = state;
+	for (const auto& name : handle.path)
 	{
-		auto child = knot.getChildWithName(key);
+		auto child = node.getChildWithName(name);
 		if (!child.isValid())
 		{
-			child = ValueTree(key);
-			knot.appendChild(child, nullptr);
+			if (!create)
+				return {};
+			child = ValueTree(name);
+			node.appendChild(child, nullptr);
 		}
-		setProperty(key, id, std::move(val), child, mngr);
-	}
-	else
-		for (auto i = 0; i < key.length(); ++i)
-			if (key[i] == '/')
-			{
-				const auto childName = key.substring(0, i);
-				auto child = knot.getChildWithName(childName);
-				if (!child.isValid())
-				{
-					child = ValueTree(childName);
-					knot.appendChild(child, nullptr);
-				}
-				return setProperty(key.substring(i + 1), id, std::move(val), child, mngr);
-			}
-}
-
-const sta::State::Var* sta::State::getProperty(const String& key, const String& id, ValueTree knot) const
-{
-	if (key.contains("/"))
-	{
-		for (auto i = 0; i < key.length(); ++i)
-			if (key[i] == '/')
-			{
-				const auto childName = key.substring(0, i);
-				const auto child = knot.getChildWithName(childName);
-				if (!child.isValid())
-					return nullptr;
-				return getProperty(key.substring(i + 1), id, child);
-			}
+		node = child;
 	}
-	const auto child = knot.getChildWithName(toID(key));
-	if (!child.isValid())
-		return nullptr;
-	if (child.hasProperty(id))
-		return &child.getProperty(id);
-	return nullptr;
+
+	handle.node = node;
+	handle.treeIdx = treeIdx;
+	return node;
 }
\ No newline at end of file
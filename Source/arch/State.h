@@ -1,10 +1,22 @@
 #pragma once
 #include <juce_data_structures/juce_data_structures.h>
 #include <juce_audio_processors/juce_audio_processors.h>
+#include <atomic>
+#include <vector>
 
 namespace sta
 {
-	class State
+	/*
+	* the patch state of the plugin.
+	* hosts get it as a versioned binary chunk: a header, one table of floats for the children of the
+	* packed key (the parameters) and the rest of the value tree in juce's binary format.
+	* loading reads the chunk in place. xml from older versions is still imported.
+	* besides the value tree it counts changes in a generation, so that serialized copies
+	* of the state know when they are outdated. values that live outside of the tree
+	* report their changes with markDirty, changes of the tree are counted automatically.
+	*/
+	class State :
+		public juce::ValueTree::Listener
 	{
 		using String = juce::String;
 		using ValueTree = juce::ValueTree;
@@ -15,16 +27,74 @@ namespace sta
 		using Proc = juce::AudioProcessor;
 
 	public:
+		// memory cap of the undo history, in property changes.
+		// juce counts a change as the size of its SetPropertyAction, which is private, so this is an estimate for 64 bit
+		static constexpr int MaxUndoChanges = 3000;
+		static constexpr int UndoUnitsPerChange = 70;
+		static constexpr int MaxUndoUnits = MaxUndoChanges * UndoUnitsPerChange;
+		static constexpr int MinUndoTransactions = 32;
+		// sets of the same property closer than this become one transaction
+		static constexpr juce::uint32 CoalesceMs = 1000;
+		// "MNTA", little endian
+		static constexpr int ChunkMagic = 0x41544e4d;
+		static constexpr int ChunkVersion = 1;
+
+		// while one exists, writes into the tree don't count as changes.
+		// for mirroring values into the tree that marked the state as changed already
+		struct ScopedSerialization
+		{
+			ScopedSerialization(State&);
+
+			~ScopedSerialization();
+
+		protected:
+			State& state;
+		};
+
+		/*
+		* a (key, id) pair resolved once: the path to the node as identifiers and a cached node.
+		* repeated gets and sets through a handle don't build strings or walk the tree.
+		*/
+		class Handle
+		{
+			friend class State;
+		public:
+			Handle();
+
+			/*key, id*/
+			Handle(const String& /*key*/, const String& /*id*/);
+
+		protected:
+			std::vector<juce::Identifier> path;
+			juce::Identifier id;
+			mutable ValueTree node;
+			// which tree the node was resolved in
+			mutable juce::uint32 treeIdx;
+		};
+
 		State();
 
 		State(const String&);
 
+		~State() override;
+
+		/* marks the state as changed. thread-safe */
+		void markDirty() noexcept;
+
+		/* changes whenever the state does. thread-safe */
+		juce::uint32 getGeneration() const noexcept;
+
+		/* key, columns. the children of key get stored as rows of floats in the binary chunk */
+		void setPackedTable(const String&, std::vector<juce::Identifier>&&);
+
+		/* proc, destData. writes the binary chunk */
 		void savePatch(const Proc&, juce::MemoryBlock&) const;
 
 		void savePatch(juce::File&) const;
 
 		void loadPatch(const XML&);
 
+		/* proc, data, sizeInBytes. reads a binary chunk or imports xml */
 		void loadPatch(const Proc&, const void* /*data*/ , int /*sizeInBytes*/);
 
 		void loadPatch(const char* /*data*/, int /*sizeInBytes*/);
@@ -45,6 +115,12 @@ namespace sta
 		/*key, id, val, undoable*/
 		void set(const String& /*key*/, const String& /*id*/, Var&&, bool /*undoable*/ = true);
 
+		/*handle, val, undoable*/
+		void set(const Handle&, Var&&, bool /*undoable*/ = true);
+
+		/*handle*/
+		const Var* get(const Handle&) const;
+
 		/*key, id*/
 		const Var* get(String&& /*key*/, String&& /*id*/) const;
 
@@ -70,12 +146,39 @@ namespace sta
 	protected:
 		ValueTree state;
 		Undo undoer;
+		// node and id of the last undoable set
+		ValueTree lastUndoableNode;
+		juce::Identifier lastUndoableID;
+		juce::uint32 lastUndoableMs;
+		// changes when the tree gets replaced, so that handles resolve again
+		juce::uint32 treeIdx;
+		std::atomic<juce::uint32> generation;
+		int numSerializing;
+		juce::Identifier packedKey;
+		std::vector<juce::Identifier> packedColumns;
 
-	private:
-		String toID(const String& /*txt*/) const;
+		/* row. true if the row has a number for each packed column */
+		bool isPackable(const ValueTree&) const;
 
-		void setProperty(const String& /*key*/, const String& /*id*/, Var&&, ValueTree /*knot*/, Undo*);
+		/* out, tree. juce's binary value tree format, without the packable rows */
+		void writeTree(juce::OutputStream&, const ValueTree&) const;
+
+		/* data, sizeInBytes. returns false if data is not a binary chunk */
+		bool loadChunk(const void*, int);
+
+		void valueTreePropertyChanged(ValueTree&, const juce::Identifier&) override;
+
+		void valueTreeChildAdded(ValueTree&, ValueTree&) override;
+
+		void valueTreeChildRemoved(ValueTree&, ValueTree&, int) override;
+
+		/* counts a change of the tree, unless it is being serialized */
+		void treeChanged() noexcept;
+
+	private:
+		static String toID(const String& /*txt*/);
 
-		const Var* getProperty(const String& /*key*/, const String& /*id*/, ValueTree /*knot*/) const;
+		/*handle, create. returns the node of the handle, invalid if it doesn't exist and create is false*/
+		ValueTree resolve(const Handle&, bool /*create*/) const;
 	};
 }
\ No newline at end of file
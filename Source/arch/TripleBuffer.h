@@ -0,0 +1,55 @@
+#pragma once
+#include <array>
+#include <atomic>
+
+namespace threads
+{
+	/*
+	* hands the latest version of some data from one writer thread to one reader thread without locking.
+	* both sides always own a whole buffer, so the reader can never see a half written one.
+	*/
+	template<typename T>
+	class TripleBuffer
+	{
+		static constexpr int DirtyBit = 4;
+	public:
+		TripleBuffer() :
+			buffers(),
+			middle(1),
+			writeIdx(0),
+			readIdx(2)
+		{}
+
+		/* writer only */
+		T& getWriteBuffer() noexcept
+		{
+			return buffers[writeIdx];
+		}
+
+		/* writer only. makes the write buffer the latest one */
+		void publish() noexcept
+		{
+			writeIdx = middle.exchange(writeIdx | DirtyBit, std::memory_order_acq_rel) & ~DirtyBit;
+		}
+
+		/* reader only. returns true if something was published since the last call */
+		bool update() noexcept
+		{
+			if ((middle.load(std::memory_order_relaxed) & DirtyBit) == 0)
+				return false;
+			readIdx = middle.exchange(readIdx, std::memory_order_acq_rel) & ~DirtyBit;
+			return true;
+		}
+
+		/* reader only */
+		const T& getReadBuffer() const noexcept
+		{
+			return buffers[readIdx];
+		}
+
+	protected:
+		std::array<T, 3> buffers;
+		std::atomic<int> middle;
+		int writeIdx, readIdx;
+	};
+}
@@ -0,0 +1,150 @@
+#include "WorkerPool.h"
+#include <juce_audio_basics/juce_audio_basics.h>
+
+#if JUCE_INTEL
+#include <immintrin.h>
+#endif
+#include <thread>
+
+namespace threads
+{
+	void pause() noexcept
+	{
+#if JUCE_INTEL
+		_mm_pause();
+#else
+		std::this_thread::yield();
+#endif
+	}
+
+	// Worker
+
+	WorkerPool::Worker::Worker(WorkerPool& _pool) :
+		juce::Thread("Manta Worker"),
+		pool(_pool),
+		sleeping(false)
+	{
+	}
+
+	void WorkerPool::Worker::run()
+	{
+		// the lanes' filters and feedback delays decay into denormals just like on the audio thread
+		const juce::ScopedNoDenormals noDenormals;
+
+		auto seen = static_cast<uint32_t>(pool.state.load() >> 32);
+
+		while (!threadShouldExit())
+		{
+			auto gen = seen;
+			for (auto i = 0; i < SpinCount && gen == seen; ++i)
+			{
+				pause();
+				gen = static_cast<uint32_t>(pool.state.load(std::memory_order_acquire) >> 32);
+			}
+
+			if (gen == seen)
+			{
+				sleeping.store(true);
+				// returns right away if a job got posted after announcing the sleep, so it can't be missed
+				pool.posted.wait(seen);
+				sleeping.store(false);
+				continue;
+			}
+
+			seen = gen;
+			pool.work(gen);
+		}
+	}
+
+	// WorkerPool
+
+	WorkerPool::WorkerPool() :
+		workers(),
+		posted(0),
+		state(0),
+		job(nullptr),
+		numTasks(0),
+		numDone(0),
+		generation(0)
+	{
+	}
+
+	WorkerPool::~WorkerPool()
+	{
+		stopWorkers();
+	}
+
+	void WorkerPool::setNumWorkers(int numWorkers)
+	{
+		if (getNumWorkers() == numWorkers)
+			return;
+
+		stopWorkers();
+		for (auto i = 0; i < numWorkers; ++i)
+		{
+			workers.emplace_back(std::make_unique<Worker>(*this));
+			workers.back()->startThread(juce::Thread::Priority::highest);
+		}
+	}
+
+	int WorkerPool::getNumWorkers() const noexcept
+	{
+		return static_cast<int>(workers.size());
+	}
+
+	void WorkerPool::operator()(Job& _job, int _numTasks) noexcept
+	{
+		job.store(&_job, std::memory_order_relaxed);
+		numTasks.store(_numTasks, std::memory_order_relaxed);
+		numDone.store(0, std::memory_order_relaxed);
+
+		++generation;
+		state.store(static_cast<uint64_t>(generation) << 32);
+		posted.store(generation);
+
+		for (auto& worker : workers)
+			if (worker->sleeping.load())
+			{
+				posted.notify_all();
+				break;
+			}
+
+		work(generation);
+
+		while (numDone.load(std::memory_order_acquire) != _numTasks)
+			pause();
+	}
+
+	void WorkerPool::work(uint32_t gen) noexcept
+	{
+		auto s = state.load(std::memory_order_acquire);
+		while (static_cast<uint32_t>(s >> 32) == gen)
+		{
+			const auto taskIdx = static_cast<int>(s & 0xffffffff);
+			if (taskIdx >= numTasks.load(std::memory_order_relaxed))
+				return;
+
+			// the generation is part of the ticket, so a late worker can't take a task of the next job
+			if (state.compare_exchange_weak(s, s + 1, std::memory_order_acq_rel))
+			{
+				job.load(std::memory_order_relaxed)->processTask(taskIdx);
+				numDone.fetch_add(1, std::memory_order_release);
+				s = state.load(std::memory_order_acquire);
+			}
+		}
+	}
+
+	void WorkerPool::stopWorkers()
+	{
+		for (auto& worker : workers)
+			worker->signalThreadShouldExit();
+		// a generation no job has, so sleepers wake up and see that they should exit
+		posted.fetch_add(1);
+		posted.notify_all();
+		for (auto& worker : workers)
+			worker->stopThread(1000);
+		workers.clear();
+		// new workers must find the generation of the latest job again, or they wouldn't sleep
+		posted.store(generation);
+	}
+}
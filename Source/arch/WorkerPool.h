@@ -0,0 +1,71 @@
+#pragma once
+#include <juce_core/juce_core.h>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+/*
+* a small pool of workers that the audio thread can hand tasks to without locking or allocating.
+* workers spin for a short while after each job, so consecutive jobs are picked up immediately,
+* and only go to sleep when the audio thread has been quiet for longer. sleepers wait on an atomic,
+* so waking them is a futex wake (or the system's equivalent) and never blocks the audio thread.
+* the calling thread takes tasks as well and spins until all of them are done.
+* a pool starts without workers, so owners that never have enough work for them don't pay for idle threads.
+*/
+
+namespace threads
+{
+	class WorkerPool
+	{
+		// ~100us of spinning before a worker goes to sleep
+		static constexpr int SpinCount = 1 << 12;
+	public:
+		struct Job
+		{
+			virtual ~Job() = default;
+
+			/* taskIdx */
+			virtual void processTask(int) noexcept = 0;
+		};
+
+		WorkerPool();
+
+		~WorkerPool();
+
+		/* numWorkers. starts or stops workers, never while a job runs */
+		void setNumWorkers(int);
+
+		int getNumWorkers() const noexcept;
+
+		/* job, numTasks. returns once all tasks are done */
+		void operator()(Job&, int) noexcept;
+
+	protected:
+		struct Worker :
+			public juce::Thread
+		{
+			Worker(WorkerPool&);
+
+			void run() override;
+
+			WorkerPool& pool;
+			std::atomic<bool> sleeping;
+		};
+
+		std::vector<std::unique_ptr<Worker>> workers;
+		// the generation of the latest job, what sleeping workers wait on
+		std::atomic<uint32_t> posted;
+		// generation in the upper, next task index in the lower 32 bits
+		std::atomic<uint64_t> state;
+		std::atomic<Job*> job;
+		std::atomic<int> numTasks, numDone;
+		uint32_t generation;
+
+	private:
+		/* generation. takes tasks of that generation until there are none left */
+		void work(uint32_t) noexcept;
+
+		void stopWorkers();
+	};
+}
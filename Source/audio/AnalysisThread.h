@@ -0,0 +1,24 @@
+#pragma once
+#include <juce_core/juce_core.h>
+
+namespace audio
+{
+	/*
+	* one low priority thread that all plugin instances share for their visual analysis.
+	* hold it with a juce::SharedResourcePointer, it only runs while at least one instance exists.
+	*/
+	struct AnalysisThread :
+		public juce::TimeSliceThread
+	{
+		AnalysisThread() :
+			juce::TimeSliceThread("Manta Analysis")
+		{
+			startThread(juce::Thread::Priority::low);
+		}
+
+		~AnalysisThread() override
+		{
+			stopThread(1000);
+		}
+	};
+}
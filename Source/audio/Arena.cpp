@@ -0,0 +1,93 @@
+#include "Arena.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+namespace audio
+{
+	Arena::Arena() :
+		data(),
+		scratch(),
+		base(nullptr),
+		capacity(0),
+		used(0),
+		measuredSampleRate(0.),
+		measuredBlockSize(0),
+		measuredNumChannels(0),
+		measuring(false)
+	{}
+
+	bool Arena::fits(double sampleRate, int blockSize, int numChannels) const noexcept
+	{
+		// the oversampling filters get longer at lower sample rates, so the rate has to match exactly
+		return sampleRate == measuredSampleRate
+			&& blockSize <= measuredBlockSize
+			&& numChannels <= measuredNumChannels;
+	}
+
+	void Arena::beginMeasure()
+	{
+		measuring = true;
+		used = 0;
+		scratch.clear();
+	}
+
+	void Arena::endMeasure(double sampleRate, int blockSize, int numChannels)
+	{
+		measuring = false;
+		measuredSampleRate = sampleRate;
+		measuredBlockSize = blockSize;
+		measuredNumChannels = numChannels;
+
+		if (used > capacity)
+		{
+			capacity = used;
+			data.allocate(capacity + Alignment, false);
+			const auto adr = reinterpret_cast<uintptr_t>(data.get());
+			base = data.get() + (Alignment - adr % Alignment) % Alignment;
+		}
+
+		used = 0;
+		scratch.clear();
+	}
+
+	void Arena::reset() noexcept
+	{
+		used = 0;
+		scratch.clear();
+	}
+
+	float** Arena::alloc(AudioBuffer& buffer, int numChannels, int numSamples)
+	{
+		auto channels = alloc<float*>(numChannels);
+		for (auto ch = 0; ch < numChannels; ++ch)
+			channels[ch] = alloc<float>(numSamples);
+		buffer.setDataToReferTo(channels, numChannels, numSamples);
+		return channels;
+	}
+
+	size_t Arena::getCapacity() const noexcept
+	{
+		return capacity;
+	}
+
+	void* Arena::allocBytes(size_t numBytes)
+	{
+		// every allocation starts on its own cache line, empty ones still get a valid address
+		numBytes = std::max(Alignment, (numBytes + Alignment - 1) / Alignment * Alignment);
+
+		if (!measuring && used + numBytes <= capacity)
+		{
+			auto ptr = base + used;
+			used += numBytes;
+			std::memset(ptr, 0, numBytes);
+			return ptr;
+		}
+
+		// an allocation that was not measured would be a bug, but it must not crash the host
+		jassert(measuring);
+		used += numBytes;
+		scratch.emplace_back(numBytes, true);
+		return scratch.back().get();
+	}
+}
@@ -0,0 +1,57 @@
+#pragma once
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <vector>
+
+namespace audio
+{
+	/*
+	* one contiguous block that all per-block and ring buffers of the engine are carved from.
+	* it is measured once with the most demanding mode (hq, lookahead) for the host's
+	* sampleRate, blockSize and channel count, so that switching modes only re-slices it.
+	* the memory handed out is zeroed and stays valid until the next reset or measurement.
+	*/
+	class Arena
+	{
+		using AudioBuffer = juce::AudioBuffer<float>;
+		static constexpr size_t Alignment = 64;
+	public:
+		Arena();
+
+		/* sampleRate, blockSize, numChannels. true if the last measurement covers these */
+		bool fits(double, int, int) const noexcept;
+
+		/* subsequent allocations only count their size and are backed by temporary memory */
+		void beginMeasure();
+
+		/* sampleRate, blockSize, numChannels. grows the arena to what was counted */
+		void endMeasure(double, int, int);
+
+		/* starts handing out memory from the beginning again */
+		void reset() noexcept;
+
+		/* size */
+		template<typename T>
+		T* alloc(int size)
+		{
+			return static_cast<T*>(allocBytes(static_cast<size_t>(size) * sizeof(T)));
+		}
+
+		/* buffer, numChannels, numSamples. makes the buffer refer to arena memory and returns its channels */
+		float** alloc(AudioBuffer&, int, int);
+
+		size_t getCapacity() const noexcept;
+
+	protected:
+		juce::HeapBlock<char> data;
+		std::vector<juce::HeapBlock<char>> scratch;
+		char* base;
+		size_t capacity, used;
+		double measuredSampleRate;
+		int measuredBlockSize, measuredNumChannels;
+		bool measuring;
+
+	private:
+		/* numBytes */
+		void* allocBytes(size_t);
+	};
+}
@@ -0,0 +1,100 @@
+#include "ChannelLink.h"
+#include "AudioUtils.h"
+#include <algorithm>
+#include <cmath>
+
+namespace audio
+{
+	ChannelLink::ChannelLink() :
+		linked(false),
+		unlinking(false),
+		identical(false),
+		converged(false)
+	{}
+
+	void ChannelLink::prepare() noexcept
+	{
+		linked = false;
+		unlinking = false;
+		identical = false;
+		converged = false;
+	}
+
+	int ChannelLink::operator()(const float* const* samples, int numChannels, int numSamples) noexcept
+	{
+		unlinking = false;
+		if (numChannels < 2)
+			return numChannels;
+
+		identical = areIdentical(samples, numChannels, numSamples);
+
+		if (linked)
+		{
+			if (!identical)
+			{
+				linked = false;
+				converged = false;
+				unlinking = true;
+			}
+		}
+		else if (identical && converged)
+			linked = true;
+
+		return linked ? 1 : numChannels;
+	}
+
+	void ChannelLink::processWet(float* const* samples, int numChannels, int numSamples) noexcept
+	{
+		if (numChannels < 2)
+			return;
+
+		if (linked)
+		{
+			for (auto ch = 1; ch < numChannels; ++ch)
+				SIMD::copy(samples[ch], samples[0], numSamples);
+			return;
+		}
+
+		if (!identical)
+		{
+			converged = false;
+			return;
+		}
+
+		auto maxDif = 0.f;
+		for (auto ch = 1; ch < numChannels; ++ch)
+		{
+			const auto smpls = samples[ch];
+			for (auto s = 0; s < numSamples; ++s)
+			{
+				// written so that a nan makes it through and counts as not converged
+				const auto dif = std::abs(smpls[s] - samples[0][s]);
+				if (!(dif <= maxDif))
+					maxDif = dif;
+			}
+		}
+		converged = maxDif < ConvergenceThreshold;
+	}
+
+	bool ChannelLink::isUnlinking() const noexcept
+	{
+		return unlinking;
+	}
+
+	bool ChannelLink::isLinked() const noexcept
+	{
+		return linked;
+	}
+
+	bool ChannelLink::areIdentical(const float* const* samples, int numChannels, int numSamples) const noexcept
+	{
+		for (auto ch = 1; ch < numChannels; ++ch)
+		{
+			const auto smpls = samples[ch];
+			for (auto s = 0; s < numSamples; ++s)
+				if (smpls[s] != samples[0][s])
+					return false;
+		}
+		return true;
+	}
+}
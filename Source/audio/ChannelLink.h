@@ -0,0 +1,39 @@
+#pragma once
+
+namespace audio
+{
+	/*
+	* detects when all channels carry the same signal (like mono material on a stereo track),
+	* so that only the first channel has to go through the wet path.
+	* it only links once the wet channels have converged, and the caller copies the
+	* first channel's state to the others on unlinking, so both transitions are seamless.
+	*/
+	struct ChannelLink
+	{
+		// max abs difference of the wet channels to consider their states converged (-120db)
+		static constexpr float ConvergenceThreshold = .000001f;
+
+		ChannelLink();
+
+		/* forgets the link, the wet states are reset or might not match anymore */
+		void prepare() noexcept;
+
+		/* samples, numChannels, numSamples. returns the number of channels that need to be processed */
+		int operator()(const float* const*, int, int) noexcept;
+
+		/* wetSamples, numChannels, numSamples. duplicates the first channel if linked */
+		void processWet(float* const*, int, int) noexcept;
+
+		/* true for the block in which the channels diverged again */
+		bool isUnlinking() const noexcept;
+
+		bool isLinked() const noexcept;
+
+	protected:
+		bool linked, unlinking, identical, converged;
+
+	private:
+		/* samples, numChannels, numSamples */
+		bool areIdentical(const float* const*, int, int) const noexcept;
+	};
+}
@@ -17,9 +17,9 @@ namespace audio
 		dryBuf()
 	{}
 
-	void DryWetMix::prepare(float sampleRate, int blockSize, int latency)
+	void DryWetMix::prepare(Arena& arena, float sampleRate, int numChannels, int blockSize, int latency)
 	{
-		latencyCompensation.prepare(blockSize, latency);
+		latencyCompensation.prepare(arena, numChannels, blockSize, latency);
 
 #if PPDHasGainIn
 		gainInSmooth.makeFromDecayInMs(20.f, sampleRate);
@@ -27,9 +27,8 @@ namespace audio
 		mixSmooth.makeFromDecayInMs(20.f, sampleRate);
 		gainOutSmooth.makeFromDecayInMs(20.f, sampleRate);
 
-		dryBuf.setSize(2, blockSize, false, true, false);
-
-		buffers.setSize(NumBufs, blockSize, false, true, false);
+		arena.alloc(dryBuf, numChannels, blockSize);
+		arena.alloc(buffers, NumBufs, blockSize);
 	}
 
 	void DryWetMix::saveDry(float* const* samples, int numChannels, int numSamples,
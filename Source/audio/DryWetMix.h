@@ -19,8 +19,8 @@ namespace audio
 	public:
 		DryWetMix();
 
-		/* sampleRate, blockSize, latency */
-		void prepare(float, int, int);
+		/* arena, sampleRate, numChannels, blockSize, latency */
+		void prepare(Arena&, float, int, int, int);
 
 		/* samples, numChannels, numSamples, gainInP, unityGainP, mixP, gainOutP, polarityP*/
 		void saveDry
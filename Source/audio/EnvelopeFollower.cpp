@@ -22,6 +22,14 @@ namespace audio
 		}
 	}
 
+	void EnvFol::reset() noexcept
+	{
+		env = 0.f;
+		state = State::Fall;
+		smoothie.reset();
+		smoothie.makeFromDecayInMs(fall, Fs);
+	}
+
 	void EnvFol::operator()(float* buf, const float* smpls, int numSamples,
 		float _riseInMs, float _fallInMs) noexcept
 	{
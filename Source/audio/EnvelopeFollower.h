@@ -17,6 +17,9 @@ namespace audio
 		// Fs
 		void prepare(float) noexcept;
 
+		/* back to silence */
+		void reset() noexcept;
+
 		/* buf, smpls, numSamples, riseInMs, fallInMs */
 		void operator()(float*, const float*, int,
 			float, float) noexcept;
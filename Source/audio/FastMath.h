@@ -0,0 +1,197 @@
+#pragma once
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+
+/*
+* branch-free approximations of the transcendentals that run at audio rate.
+* every function is written so that the array-level entry points auto-vectorize.
+* error bounds are measured over the stated domain against the double precision libm.
+*/
+
+namespace audio::math
+{
+	static constexpr float Log2E = 1.44269504089f;
+	static constexpr float Log2Of10 = 3.32192809489f;
+	static constexpr float PiF = 3.14159265359f;
+	static constexpr float PiFInv = 1.f / PiF;
+	// cody-waite split of pi for the sin/cos range reduction
+	static constexpr float PiA = 3.140625f;
+	static constexpr float PiB = 9.67502593994140625e-4f;
+	static constexpr float PiC = 1.509957990978376432e-7f;
+
+	/* x [-126, 127], rel err < 2e-7 */
+	inline float exp2(float x) noexcept
+	{
+		x = std::min(std::max(x, -126.f), 127.f);
+		const auto xFloor = std::floor(x);
+		const auto f = x - xFloor;
+		const auto i = static_cast<int32_t>(xFloor);
+
+		// minimax of 2^f on [0, 1[
+		auto p = 1.8775767e-3f;
+		p = p * f + 8.9893397e-3f;
+		p = p * f + 5.5826318e-2f;
+		p = p * f + 2.4015361e-1f;
+		p = p * f + 6.9315308e-1f;
+		p = p * f + 9.9999994e-1f;
+
+		const auto scale = std::bit_cast<float>((i + 127) << 23);
+		return p * scale;
+	}
+
+	/* x ]0, inf[, abs err < 2e-7 for |log2(x)| < 1, rel err < 2e-7 otherwise */
+	inline float log2(float x) noexcept
+	{
+		const auto bits = std::bit_cast<int32_t>(x);
+		auto e = ((bits >> 23) & 0xff) - 127;
+		auto m = std::bit_cast<float>((bits & 0x007fffff) | 0x3f800000);
+
+		// shift mantissa into [sqrt(.5), sqrt(2)[ so the series converges fast
+		const auto big = m > 1.41421356f;
+		m = big ? m * .5f : m;
+		e += big ? 1 : 0;
+
+		const auto u = (m - 1.f) / (m + 1.f);
+		const auto u2 = u * u;
+		auto p = 1.f / 9.f;
+		p = p * u2 + 1.f / 7.f;
+		p = p * u2 + 1.f / 5.f;
+		p = p * u2 + 1.f / 3.f;
+		p = p * u2 + 1.f;
+
+		return static_cast<float>(e) + 2.f * Log2E * u * p;
+	}
+
+	/* x ]-inf, inf[, abs err < 3e-7 */
+	inline float tanh(float x) noexcept
+	{
+		const auto ax = std::min(std::abs(x), 9.f);
+		const auto t = exp2(-2.f * Log2E * ax);
+		const auto y = (1.f - t) / (1.f + t);
+		return std::copysign(y, x);
+	}
+
+	/* x [-8192pi, 8192pi], abs err < 2e-7 */
+	inline float sin(float x) noexcept
+	{
+		const auto k = std::nearbyint(x * PiFInv);
+		const auto r = ((x - k * PiA) - k * PiB) - k * PiC;
+		const auto r2 = r * r;
+
+		auto p = -2.5052108e-8f;
+		p = p * r2 + 2.7557319e-6f;
+		p = p * r2 - 1.9841270e-4f;
+		p = p * r2 + 8.3333333e-3f;
+		p = p * r2 - 1.6666667e-1f;
+		const auto y = r + r * r2 * p;
+
+		const auto odd = static_cast<int32_t>(k) & 1;
+		return odd ? -y : y;
+	}
+
+	/* x [-8192pi, 8192pi], abs err < 2e-7 */
+	inline float cos(float x) noexcept
+	{
+		const auto k = std::nearbyint(x * PiFInv);
+		const auto r = ((x - k * PiA) - k * PiB) - k * PiC;
+		const auto r2 = r * r;
+
+		auto p = 2.0876757e-9f;
+		p = p * r2 - 2.7557319e-7f;
+		p = p * r2 + 2.4801587e-5f;
+		p = p * r2 - 1.3888889e-3f;
+		p = p * r2 + 4.1666667e-2f;
+		p = p * r2 - .5f;
+		const auto y = 1.f + r2 * p;
+
+		const auto odd = static_cast<int32_t>(k) & 1;
+		return odd ? -y : y;
+	}
+
+	/* base, exponent. base ]0, inf[ */
+	inline float pow(float base, float exponent) noexcept
+	{
+		return exp2(exponent * log2(base));
+	}
+
+	/* note, rootNote, xen, masterTune */
+	inline float noteInFreqHz(float note, float rootNote = 69.f, float xen = 12.f, float masterTune = 440.f) noexcept
+	{
+		return exp2((note - rootNote) / xen) * masterTune;
+	}
+
+	inline float decibelToGain(float db) noexcept
+	{
+		return exp2(db * (Log2Of10 * .05f));
+	}
+
+	/* x, a [0, 1[ */
+	inline float softclip(float x, float a) noexcept
+	{
+		const auto l = std::max(std::min(x, a), -a);
+		const auto A = 1.f - a;
+		const auto X = (x - l) / A;
+
+		return l + A * tanh(X);
+	}
+
+	// array-level entry points
+
+	/* dest, src, numSamples */
+	inline void tanh(float* dest, const float* src, int numSamples) noexcept
+	{
+		for (auto s = 0; s < numSamples; ++s)
+			dest[s] = tanh(src[s]);
+	}
+
+	/* buffer, numSamples */
+	inline void tanh(float* buffer, int numSamples) noexcept
+	{
+		tanh(buffer, buffer, numSamples);
+	}
+
+	/* dest, src, numSamples */
+	inline void sin(float* dest, const float* src, int numSamples) noexcept
+	{
+		for (auto s = 0; s < numSamples; ++s)
+			dest[s] = sin(src[s]);
+	}
+
+	/* dest, src, numSamples */
+	inline void cos(float* dest, const float* src, int numSamples) noexcept
+	{
+		for (auto s = 0; s < numSamples; ++s)
+			dest[s] = cos(src[s]);
+	}
+
+	/* dest, src, numSamples */
+	inline void exp2(float* dest, const float* src, int numSamples) noexcept
+	{
+		for (auto s = 0; s < numSamples; ++s)
+			dest[s] = exp2(src[s]);
+	}
+
+	/* dest, src, numSamples */
+	inline void log2(float* dest, const float* src, int numSamples) noexcept
+	{
+		for (auto s = 0; s < numSamples; ++s)
+			dest[s] = log2(src[s]);
+	}
+
+	/* buffer (notes in, freqHz out), numSamples, rootNote, xen, masterTune */
+	inline void noteInFreqHz(float* buffer, int numSamples, float rootNote, float xen, float masterTune) noexcept
+	{
+		const auto xenInv = 1.f / xen;
+		for (auto s = 0; s < numSamples; ++s)
+			buffer[s] = exp2((buffer[s] - rootNote) * xenInv) * masterTune;
+	}
+
+	/* buffer, numSamples, a [0, 1[ */
+	inline void softclip(float* buffer, int numSamples, float a) noexcept
+	{
+		for (auto s = 0; s < numSamples; ++s)
+			buffer[s] = softclip(buffer[s], a);
+	}
+}
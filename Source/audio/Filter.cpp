@@ -1,4 +1,6 @@
 #include "Filter.h"
+#include "FastMath.h"
+#include <algorithm>
 
 namespace audio
 {
@@ -33,8 +35,8 @@ namespace audio
 	void FilterBandpass::setFc(float fc, float q) noexcept
 	{
 		const auto omega = Tau * fc;
-		cosOmega = -2.f * std::cos(omega);
-		const auto sinOmega = std::sin(omega);
+		cosOmega = -2.f * math::cos(omega);
+		const auto sinOmega = math::sin(omega);
 		alpha = sinOmega / (2.f * q);
 
 		updateCoefficients();
@@ -172,4 +174,117 @@ namespace audio
 	template struct FilterBandpassSlope<6>;
 	template struct FilterBandpassSlope<7>;
 	template struct FilterBandpassSlope<8>;
+
+	// FilterBandpassSlopeMulti
+
+	template<size_t NumFilters>
+	FilterBandpassSlopeMulti<NumFilters>::FilterBandpassSlopeMulti() :
+		x1(),
+		x2(),
+		y1(),
+		y2(),
+		x0(),
+		a0(0.f),
+		b1(0.f),
+		b2(0.f),
+		stage(1),
+		numChannels(0)
+	{}
+
+	template<size_t NumFilters>
+	void FilterBandpassSlopeMulti<NumFilters>::prepare(int _numChannels)
+	{
+		numChannels = _numChannels;
+		const auto size = NumFilters * numChannels;
+		x1.assign(size, 0.f);
+		x2.assign(size, 0.f);
+		y1.assign(size, 0.f);
+		y2.assign(size, 0.f);
+		x0.assign(numChannels, 0.f);
+	}
+
+	template<size_t NumFilters>
+	void FilterBandpassSlopeMulti<NumFilters>::clear() noexcept
+	{
+		std::fill(x1.begin(), x1.end(), 0.f);
+		std::fill(x2.begin(), x2.end(), 0.f);
+		std::fill(y1.begin(), y1.end(), 0.f);
+		std::fill(y2.begin(), y2.end(), 0.f);
+	}
+
+	template<size_t NumFilters>
+	void FilterBandpassSlopeMulti<NumFilters>::setStage(int s) noexcept
+	{
+		stage = s;
+	}
+
+	template<size_t NumFilters>
+	void FilterBandpassSlopeMulti<NumFilters>::setFc(float fc, float q) noexcept
+	{
+		const auto omega = Tau * fc;
+		const auto cosOmega = -2.f * math::cos(omega);
+		const auto alpha = math::sin(omega) / (2.f * q);
+		const auto b0Inv = 1.f / (1.f + alpha);
+
+		a0 = alpha * b0Inv;
+		b1 = cosOmega * b0Inv;
+		b2 = (1.f - alpha) * b0Inv;
+	}
+
+	template<size_t NumFilters>
+	void FilterBandpassSlopeMulti<NumFilters>::operator()(float* const* dest, const float* const* src,
+		int numCh, int s) noexcept
+	{
+		auto x = x0.data();
+		for (auto ch = 0; ch < numCh; ++ch)
+			x[ch] = src[ch][s];
+
+		for (auto i = 0; i < stage; ++i)
+		{
+			const auto off = i * numChannels;
+			auto sx1 = x1.data() + off;
+			auto sx2 = x2.data() + off;
+			auto sy1 = y1.data() + off;
+			auto sy2 = y2.data() + off;
+
+			for (auto ch = 0; ch < numCh; ++ch)
+			{
+				const auto y = a0 * (x[ch] - sx2[ch]) - b1 * sy1[ch] - b2 * sy2[ch];
+
+				sx2[ch] = sx1[ch];
+				sx1[ch] = x[ch];
+				sy2[ch] = sy1[ch];
+				sy1[ch] = y;
+				x[ch] = y;
+			}
+		}
+
+		for (auto ch = 0; ch < numCh; ++ch)
+			dest[ch][s] = x[ch];
+	}
+
+	template<size_t NumFilters>
+	void FilterBandpassSlopeMulti<NumFilters>::copyFirstChannelState() noexcept
+	{
+		for (auto i = 0; i < NumFilters; ++i)
+		{
+			const auto off = i * numChannels;
+			for (auto ch = 1; ch < numChannels; ++ch)
+			{
+				x1[off + ch] = x1[off];
+				x2[off + ch] = x2[off];
+				y1[off + ch] = y1[off];
+				y2[off + ch] = y2[off];
+			}
+		}
+	}
+
+	template struct FilterBandpassSlopeMulti<1>;
+	template struct FilterBandpassSlopeMulti<2>;
+	template struct FilterBandpassSlopeMulti<3>;
+	template struct FilterBandpassSlopeMulti<4>;
+	template struct FilterBandpassSlopeMulti<5>;
+	template struct FilterBandpassSlopeMulti<6>;
+	template struct FilterBandpassSlopeMulti<7>;
+	template struct FilterBandpassSlopeMulti<8>;
 }
\ No newline at end of file
@@ -2,6 +2,7 @@
 #include "../arch/Conversion.h"
 #include <cmath>
 #include <complex>
+#include <vector>
 
 namespace audio
 {
@@ -57,4 +58,38 @@ namespace audio
 		std::array<FilterBandpass, NumFilters> filters;
 		int stage;
 	};
+
+	/*
+	* a bandpass slope for any number of channels.
+	* the coefficients are computed once per sample and shared by all channels.
+	* the state is stored channel-contiguous per stage, so the channel loops vectorize.
+	*/
+	template<size_t NumFilters>
+	struct FilterBandpassSlopeMulti
+	{
+		FilterBandpassSlopeMulti();
+
+		/* numChannels */
+		void prepare(int);
+
+		void clear() noexcept;
+
+		void setStage(int) noexcept;
+
+		/* frequency fc [0, .5[, q-factor q [1, 160..] */
+		void setFc(float fc, float q) noexcept;
+
+		/* dest, src, numChannels, sampleIdx */
+		void operator()(float* const*, const float* const*, int, int) noexcept;
+
+		/* copies the state of the first channel to all others */
+		void copyFirstChannelState() noexcept;
+
+	protected:
+		// [stage * numChannels + ch]
+		std::vector<float> x1, x2, y1, y2;
+		std::vector<float> x0;
+		float a0, b1, b2;
+		int stage, numChannels;
+	};
 }
\ No newline at end of file
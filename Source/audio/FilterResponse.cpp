@@ -0,0 +1,113 @@
+#include "FilterResponse.h"
+#include "FastMath.h"
+#include "../arch/Conversion.h"
+#include <algorithm>
+#include <cmath>
+
+namespace audio
+{
+	FilterResponse::FilterResponse() :
+		sumRe(),
+		sumIm(),
+		re(),
+		im(),
+		stageRe(),
+		stageIm()
+	{}
+
+	void FilterResponse::prepare(int numPoints)
+	{
+		if (static_cast<int>(sumRe.size()) >= numPoints)
+			return;
+		sumRe.resize(numPoints);
+		sumIm.resize(numPoints);
+		re.resize(numPoints);
+		im.resize(numPoints);
+		stageRe.resize(numPoints);
+		stageIm.resize(numPoints);
+	}
+
+	void FilterResponse::operator()(float* mags, const float* fcs, int numPoints,
+		const Lane* lanes, int numLanes) noexcept
+	{
+		prepare(numPoints);
+		std::fill(sumRe.begin(), sumRe.begin() + numPoints, 0.f);
+		std::fill(sumIm.begin(), sumIm.begin() + numPoints, 0.f);
+
+		for (auto l = 0; l < numLanes; ++l)
+			if (lanes[l].enabled && lanes[l].gain != 0.f)
+				addLane(fcs, numPoints, lanes[l]);
+
+		const auto sr = sumRe.data();
+		const auto si = sumIm.data();
+		for (auto i = 0; i < numPoints; ++i)
+			mags[i] = std::sqrt(sr[i] * sr[i] + si[i] * si[i]);
+	}
+
+	void FilterResponse::addLane(const float* fcs, int numPoints, const Lane& lane) noexcept
+	{
+		// same coefficients as FilterBandpass, whose a1 is 0 and a2 is -a0
+		const auto omega = Tau * lane.fc;
+		const auto alpha = math::sin(omega) / (2.f * lane.q);
+		const auto b0Inv = 1.f / (1.f + alpha);
+		const auto a0 = alpha * b0Inv;
+		const auto b1 = -2.f * math::cos(omega) * b0Inv;
+		const auto b2 = (1.f - alpha) * b0Inv;
+
+		auto r = re.data();
+		auto m = im.data();
+		auto sRe = stageRe.data();
+		auto sIm = stageIm.data();
+
+		// one stage: a0 * (1 - z^-2) / (1 + b1 * z^-1 + b2 * z^-2)
+		for (auto i = 0; i < numPoints; ++i)
+		{
+			const auto w = Tau * fcs[i];
+			const auto c1 = math::cos(w);
+			const auto s1 = math::sin(w);
+			const auto c2 = c1 * c1 - s1 * s1;
+			const auto s2 = 2.f * s1 * c1;
+
+			const auto nRe = a0 * (1.f - c2);
+			const auto nIm = a0 * s2;
+			const auto dRe = 1.f + b1 * c1 + b2 * c2;
+			const auto dIm = -(b1 * s1 + b2 * s2);
+			const auto dInv = 1.f / std::max(dRe * dRe + dIm * dIm, 1e-20f);
+
+			sRe[i] = (nRe * dRe + nIm * dIm) * dInv;
+			sIm[i] = (nIm * dRe - nRe * dIm) * dInv;
+		}
+
+		// the stages of a slope share their coefficients, so the slope is a power of one stage
+		std::copy(sRe, sRe + numPoints, r);
+		std::copy(sIm, sIm + numPoints, m);
+		for (auto s = 1; s < lane.slope; ++s)
+			for (auto i = 0; i < numPoints; ++i)
+			{
+				const auto tRe = r[i] * sRe[i] - m[i] * sIm[i];
+				m[i] = r[i] * sIm[i] + m[i] * sRe[i];
+				r[i] = tRe;
+			}
+
+		// feedback comb: 1 / (1 - fb * z^-delay), scaled by the lane's gain
+		const auto fb = lane.feedback;
+		const auto delay = lane.delaySamples;
+		const auto gain = lane.gain;
+		auto sumR = sumRe.data();
+		auto sumI = sumIm.data();
+		for (auto i = 0; i < numPoints; ++i)
+		{
+			// wrapped into one cycle first, long delays would leave the range of the fast sin and cos
+			auto cycles = fcs[i] * delay;
+			cycles -= std::floor(cycles);
+			const auto w = Tau * cycles;
+
+			const auto dRe = 1.f - fb * math::cos(w);
+			const auto dIm = fb * math::sin(w);
+			const auto dInv = gain / std::max(dRe * dRe + dIm * dIm, 1e-6f);
+
+			sumR[i] += (r[i] * dRe + m[i] * dIm) * dInv;
+			sumI[i] += (m[i] * dRe - r[i] * dIm) * dInv;
+		}
+	}
+}
@@ -0,0 +1,38 @@
+#pragma once
+#include <vector>
+
+namespace audio
+{
+	/*
+	* evaluates the transfer function of all lanes at once for a whole grid of frequencies.
+	* every lane is its bandpass slope, followed by the feedback comb of its delay and its gain.
+	* the lanes are summed as complex numbers, because that's how their outputs add up.
+	* distortion and ring modulation are nonlinear, so they are not part of the response.
+	* the math runs on plain float arrays (re, im) point by point, so that the loops vectorize.
+	*/
+	struct FilterResponse
+	{
+		struct Lane
+		{
+			// fc [0, .5[, q [1, N], slope [1, 4]stages, feedback [0, 1], delay in samples, gain (linear)
+			float fc, q;
+			int slope;
+			float feedback, delaySamples, gain;
+			bool enabled;
+		};
+
+		FilterResponse();
+
+		/* numPoints */
+		void prepare(int);
+
+		/* mags, fcs, numPoints, lanes, numLanes. fcs are normalized frequencies [0, .5[ */
+		void operator()(float*, const float*, int, const Lane*, int) noexcept;
+
+	protected:
+		std::vector<float> sumRe, sumIm, re, im, stageRe, stageIm;
+
+		/* fcs, numPoints, lane */
+		void addLane(const float*, int, const Lane&) noexcept;
+	};
+}
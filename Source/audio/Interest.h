@@ -0,0 +1,73 @@
+#pragma once
+#include <atomic>
+
+namespace audio
+{
+	/*
+	* counts the consumers of an analysis (like an open editor), so that the audio thread
+	* can skip it entirely while nobody looks at it.
+	*/
+	struct Interest
+	{
+		/* one consumer's registration, released when it goes out of scope */
+		class Registration
+		{
+		public:
+			Registration(Interest& _interest) :
+				interest(_interest),
+				active(false)
+			{}
+
+			~Registration()
+			{
+				setActive(false);
+			}
+
+			void setActive(bool e) noexcept
+			{
+				if (active == e)
+					return;
+				active = e;
+				if (active)
+					interest.add();
+				else
+					interest.remove();
+			}
+
+		protected:
+			Interest& interest;
+			bool active;
+		};
+
+		Interest() :
+			count(0),
+			resetRequested(false)
+		{}
+
+		void add() noexcept
+		{
+			if (count.fetch_add(1) == 0)
+				resetRequested.store(true);
+		}
+
+		void remove() noexcept
+		{
+			count.fetch_sub(1);
+		}
+
+		bool isActive() const noexcept
+		{
+			return count.load() != 0;
+		}
+
+		/* true once after the first consumer came back, so the analysis can start from a clean state */
+		bool checkReset() noexcept
+		{
+			return resetRequested.exchange(false);
+		}
+
+	protected:
+		std::atomic<int> count;
+		std::atomic<bool> resetRequested;
+	};
+}
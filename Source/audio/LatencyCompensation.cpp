@@ -18,18 +18,18 @@ namespace audio
 		latency(0)
 	{}
 
-	void LatencyCompensation::prepare(int blockSize, int _latency)
+	void LatencyCompensation::prepare(Arena& arena, int numChannels, int blockSize, int _latency)
 	{
 		latency = _latency;
 		if (latency != 0)
 		{
-			ring.setSize(2, latency, false, true, false);
-			wHead.prepare(blockSize, latency);
+			arena.alloc(ring, numChannels, latency);
+			wHead.prepare(arena, blockSize, latency);
 		}
 		else
 		{
-			ring.setSize(0, 0);
-			wHead.prepare(0, 0);
+			arena.alloc(ring, 0, 0);
+			wHead.prepare(arena, 0, 0);
 		}
 	}
 
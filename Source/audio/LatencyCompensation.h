@@ -8,8 +8,8 @@ namespace audio
 	{
 		LatencyCompensation();
 
-		/* blockSize, latency */
-		void prepare(int, int);
+		/* arena, numChannels, blockSize, latency */
+		void prepare(Arena&, int, int, int);
 
 		/* dry, inputSamples, numChannels, numSamples */
 		void operator()(float* const*, float* const*, int, int) noexcept;
@@ -23,8 +23,11 @@ namespace audio
 		assignableParam(nullptr),
 		params(_params),
 		state(_state),
+		idHandles(),
 		c(-1)
 	{
+		for (auto i = 0; i < NumCCs; ++i)
+			idHandles[i] = State::Handle(getIDString(i), "id");
 	}
 
 	void MIDILearn::savePatch() const
@@ -34,7 +37,7 @@ namespace audio
 			const auto& cc = ccBuf[i];
 			const auto prm = cc.param.load();
 			if (prm != nullptr)
-				state.set(getIDString(i), "id", param::toID(param::toString(prm->id)), true);
+				state.set(idHandles[i], param::toID(param::toString(prm->id)), true);
 		}
 	}
 
@@ -42,7 +45,7 @@ namespace audio
 	{
 		for (auto i = 0; i < ccBuf.size(); ++i)
 		{
-			const auto var = state.get(getIDString(i), "id");
+			const auto var = state.get(idHandles[i]);
 			if (var)
 			{
 				const auto idStr = var->toString();
@@ -71,6 +74,7 @@ namespace audio
 			{
 				cc.param.store(ap);
 				assignableParam.store(nullptr);
+				state.markDirty();
 			}
 
 			cc.setValue(msg.getControllerValue());
@@ -92,7 +96,10 @@ namespace audio
 	{
 		for (auto& cc : ccBuf)
 			if (param == cc.param)
+			{
 				cc.param.store(nullptr);
+				state.markDirty();
+			}
 	}
 
 	String MIDILearn::getIDString(int idx) const
@@ -8,6 +8,7 @@ namespace audio
 	class MIDILearn
 	{
 		static constexpr float ValInv = 1.f / 128.f;
+		static constexpr int NumCCs = 120;
 
 		struct CC
 		{
@@ -35,12 +36,13 @@ namespace audio
 		
 		void removeParam(param::Param*) noexcept;
 
-		std::array<CC, 120> ccBuf;
+		std::array<CC, NumCCs> ccBuf;
 		std::atomic<int> ccIdx;
 	protected:
 		std::atomic<param::Param*> assignableParam;
 		Params& params;
 		State& state;
+		std::array<State::Handle, NumCCs> idHandles;
 		int c;
 
 		String getIDString(int) const;
@@ -1,7 +1,9 @@
 #pragma once
 
 #include "../arch/Interpolation.h"
+#include "../arch/WorkerPool.h"
 
+#include "FastMath.h"
 #include "Filter.h"
 #include "PRM.h"
 #include "Phasor.h"
@@ -11,58 +13,50 @@
 
 namespace audio
 {
-	struct Manta
+	struct Manta :
+		public threads::WorkerPool::Job
 	{
 		// enabled, pitch-snap, cutoff, resonance, slope, feedback, oct, semi, heat, rm-oct, rm-semi, rm-depth, gain
 		static constexpr int NumParametersPerLane = 13;
 		static constexpr int WaveTableSize = 1 << 13; // around min 5hz
 		static constexpr int NumLanes = 3;
 		static constexpr int MaxSlopeStage = 4; //4*12db/oct
+		// numSamples * numChannels below which handing the lanes to the workers costs more than it saves
+		static constexpr int MinSamplesParallel = 512;
 		using WT = WaveTable<WaveTableSize>;
 	private:
 		class Filter
 		{
-			using Fltr = FilterBandpassSlope<MaxSlopeStage>;
+			using Fltr = FilterBandpassSlopeMulti<MaxSlopeStage>;
 		public:
 			Filter() :
 				filta()
 			{}
 
+			void prepare(int numChannels)
+			{
+				filta.prepare(numChannels);
+			}
+
+			void copyFirstChannelState() noexcept
+			{
+				filta.copyFirstChannelState();
+			}
+
 			void operator()(float* const* laneBuf, float* const* samples, int numChannels, int numSamples,
 				float* fcBuf, float* resoBuf, int stage) noexcept
 			{
-				{
-					auto lane = laneBuf[0];
-					auto smpls = samples[0];
-					auto& fltr = filta[0];
-					
-					fltr.setStage(stage);
+				filta.setStage(stage);
 
-					for (auto s = 0; s < numSamples; ++s)
-					{
-						fltr.setFc(fcBuf[s], resoBuf[s]);
-						lane[s] = fltr(smpls[s]);
-					}
-				}
-				
-				for (auto ch = 1; ch < numChannels; ++ch)
+				for (auto s = 0; s < numSamples; ++s)
 				{
-					auto lane = laneBuf[ch];
-					auto smpls = samples[ch];
-					auto& fltr = filta[ch];
-
-					fltr.setStage(stage);
-
-					for (auto s = 0; s < numSamples; ++s)
-					{
-						fltr.setFc(fcBuf[s], resoBuf[s]);
-						lane[s] = fltr(smpls[s]);
-					}
+					filta.setFc(fcBuf[s], resoBuf[s]);
+					filta(laneBuf, samples, numChannels, s);
 				}
 			}
 
 		protected:
-			std::array<Fltr, 2> filta;
+			Fltr filta;
 		};
 		
 		struct DelayFeedback
@@ -72,10 +66,16 @@ namespace audio
 				size(0)
 			{}
 
-			void prepare(int delaySize)
+			void prepare(Arena& arena, int numChannels, int delaySize)
 			{
 				size = delaySize;
-				ringBuffer.setSize(2, size, false, true, false);
+				arena.alloc(ringBuffer, numChannels, size);
+			}
+
+			void copyFirstChannelState() noexcept
+			{
+				for (auto ch = 1; ch < ringBuffer.getNumChannels(); ++ch)
+					ringBuffer.copyFrom(ch, 0, ringBuffer, 0, 0, size);
 			}
 
 			void operator()(float* const* samples, int numChannels, int numSamples, const int* wHead, const float* rHead,
@@ -114,7 +114,7 @@ namespace audio
 			RingMod() :
 				waveTable(),
 				phasor(),
-				oscBuffer()
+				oscBuffer(nullptr)
 			{
 				createWavetable([](float x) { return std::cos(x * Pi); });
 			}
@@ -124,15 +124,17 @@ namespace audio
 				waveTable.create(func);
 			}
 
-			void prepare(float Fs, int blockSize)
+			void prepare(Arena& arena, float Fs, int blockSize)
 			{
 				phasor.prepare(1.f / Fs);
-				oscBuffer.resize(blockSize, 0.f);
+				oscBuffer = arena.alloc<float>(blockSize);
 			}
 
 			void operator()(float* const* samples, int numChannels, int numSamples,
 				float* _rmDepth, float* _freqHz) noexcept
 			{
+				waveTable.update();
+
 				for (auto s = 0; s < numSamples; ++s)
 				{
 					const auto freqHz = _freqHz[s];
@@ -161,7 +163,7 @@ namespace audio
 			WT waveTable;
 		protected:
 			Phasor<float> phasor;
-			std::vector<float> oscBuffer;
+			float* oscBuffer;
 		};
 
 		struct Lane
@@ -169,7 +171,7 @@ namespace audio
 			Lane() :
 				ringMod(),
 				laneBuffer(),
-				readHead(),
+				readHead(nullptr),
 				filter(),
 				
 				frequency(.5f),
@@ -187,23 +189,24 @@ namespace audio
 				delaySizeF(1.f)
 			{}
 
-			void prepare(float sampleRate, int blockSize, int delaySize)
+			void prepare(Arena& arena, float sampleRate, int numChannels, int blockSize, int delaySize)
 			{
 				Fs = sampleRate;
 				
-				laneBuffer.setSize(2, blockSize, false, true, false);
-
-				frequency.prepare(Fs, blockSize, 10.f);
-				resonance.prepare(Fs, blockSize, 10.f);
-				drive.prepare(Fs, blockSize, 10.f);
-				feedback.prepare(Fs, blockSize, 10.f);
-				delayRate.prepare(Fs, blockSize, 10.f);
-				gain.prepare(Fs, blockSize, 10.f);
-				rmDepth.prepare(Fs, blockSize, 10.f);
-				rmFreqHz.prepare(Fs, blockSize, 10.f);
-				delayFB.prepare(delaySize);
-				readHead.resize(blockSize, 0.f);
-				ringMod.prepare(Fs, blockSize);
+				arena.alloc(laneBuffer, numChannels, blockSize);
+				filter.prepare(numChannels);
+
+				frequency.prepare(arena, Fs, blockSize, 10.f);
+				resonance.prepare(arena, Fs, blockSize, 10.f);
+				drive.prepare(arena, Fs, blockSize, 10.f);
+				feedback.prepare(arena, Fs, blockSize, 10.f);
+				delayRate.prepare(arena, Fs, blockSize, 10.f);
+				gain.prepare(arena, Fs, blockSize, 10.f);
+				rmDepth.prepare(arena, Fs, blockSize, 10.f);
+				rmFreqHz.prepare(arena, Fs, blockSize, 10.f);
+				delayFB.prepare(arena, numChannels, delaySize);
+				readHead = arena.alloc<float>(blockSize);
+				ringMod.prepare(arena, Fs, blockSize);
 
 				delaySizeF = static_cast<float>(delaySize);
 			}
@@ -259,14 +262,22 @@ namespace audio
 				applyGain(lane, numChannels, numSamples, gainBuf);
 			}
 
-			void savePatch(sta::State& state, int i)
+			void copyFirstChannelState() noexcept
 			{
-				ringMod.waveTable.savePatch(state, "manta/lane" + String(i));
+				filter.copyFirstChannelState();
+				delayFB.copyFirstChannelState();
 			}
 
-			void loadPatch(sta::State& state, int i)
+			/* state, wtHandle */
+			void savePatch(sta::State& state, const sta::State::Handle& wtHandle)
 			{
-				ringMod.waveTable.loadPatch(state, "manta/lane" + String(i));
+				ringMod.waveTable.savePatch(state, wtHandle);
+			}
+
+			/* state, wtHandle */
+			void loadPatch(sta::State& state, const sta::State::Handle& wtHandle)
+			{
+				ringMod.waveTable.loadPatch(state, wtHandle);
 			}
 
 			void addTo(float* const* samples, int numChannels, int numSamples) noexcept
@@ -280,7 +291,7 @@ namespace audio
 			RingMod ringMod;
 		protected:
 			AudioBuffer laneBuffer;
-			std::vector<float> readHead;
+			float* readHead;
 			Filter filter;
 			PRM frequency, resonance, drive, feedback, delayRate, rmDepth, rmFreqHz, gain;
 			DelayFeedback delayFB;
@@ -288,7 +299,7 @@ namespace audio
 
 			const float* getRHead(int numSamples, const int* wHead, const float* delayBuf) noexcept
 			{
-				auto rHead = readHead.data();
+				auto rHead = readHead;
 				for (auto s = 0; s < numSamples; ++s)
 				{
 					const auto w = static_cast<float>(wHead[s]);
@@ -303,7 +314,7 @@ namespace audio
 
 			float distort(float x, float d) const noexcept
 			{
-				auto w = std::tanh(256.f * x) / 256.f;
+				auto w = math::tanh(256.f * x) / 256.f;
 				return x + d * (w - x);
 			}
 
@@ -325,24 +336,62 @@ namespace audio
 			}
 		};
 
+		struct LaneArgs
+		{
+			bool enabled;
+			float pitch, resonance;
+			int slope;
+			float drive, feedback, oct, semi, rmOct, rmSemi, rmDepth, gain;
+		};
+
 	public:
 		Manta(const XenManager& _xen) :
 			xen(_xen),
 			lanes(),
 			writeHead(),
+#if PPDHasLaneThreads
+			pool(),
+			maxSamplesParallel(0),
+#endif
+			laneArgs(),
+			curSamples(nullptr),
+			curNumChannels(0),
+			curNumSamples(0),
+			curWHead(nullptr),
+			wtHandles(),
 			delaySize(1)
-		{}
+		{
+			for (auto l = 0; l < NumLanes; ++l)
+				wtHandles[l] = sta::State::Handle("manta/lane" + String(l), "wt");
+		}
 
-		void prepare(float sampleRate, int blockSize)
+		/* arena, sampleRate, numChannels, blockSize */
+		void prepare(Arena& arena, float sampleRate, int numChannels, int blockSize)
 		{
 			delaySize = static_cast<int>(std::ceil(freqHzInSamples(static_cast<float>(5.f), sampleRate)) + 3.f);
 			if (delaySize % 2 != 0)
 				++delaySize;
 
 			for (auto& lane : lanes)
-				lane.prepare(sampleRate, blockSize, delaySize);
+				lane.prepare(arena, sampleRate, numChannels, blockSize, delaySize);
+
+			writeHead.prepare(arena, blockSize, delaySize);
+
+#if PPDHasLaneThreads
+			maxSamplesParallel = blockSize * numChannels;
+#endif
+		}
 
-			writeHead.prepare(blockSize, delaySize);
+		/* enabled. starts the lane workers if enabled and if a block can ever be big enough to be worth handing to them.
+		* call once after the last prepare, not on the audio thread */
+		void updateWorkers(bool enabled)
+		{
+#if PPDHasLaneThreads
+			const auto worthIt = enabled && maxSamplesParallel >= MinSamplesParallel && juce::SystemStats::getNumCpus() > NumLanes;
+			pool.setNumWorkers(worthIt ? NumLanes - 1 : 0);
+#else
+			juce::ignoreUnused(enabled);
+#endif
 		}
 
 		/* samples, numChannels, numSamples,
@@ -355,54 +404,25 @@ namespace audio
 			bool l2Enabled, bool l2Snap, float l2Pitch, float l2Resonance, int l2Slope, float l2Drive, float l2Feedback, float l2Oct, float l2Semi, float l2RMOct, float l2RMSemi, float l2RMDepth, float l2Gain,
 			bool l3Enabled, bool l3Snap, float l3Pitch, float l3Resonance, int l3Slope, float l3Drive, float l3Feedback, float l3Oct, float l3Semi, float l3RMOct, float l3RMSemi, float l3RMDepth, float l3Gain) noexcept
 		{
-			bool enabled[NumLanes] = { l1Enabled, l2Enabled, l3Enabled };
-			float pitch[NumLanes] =
-			{
-				l1Snap ? std::rint(l1Pitch) : l1Pitch,
-				l2Snap ? std::rint(l2Pitch) : l2Pitch,
-				l3Snap ? std::rint(l3Pitch) : l3Pitch
-			};
-			float resonance[NumLanes] = { l1Resonance, l2Resonance, l3Resonance };
-			int slope[NumLanes] = { l1Slope, l2Slope, l3Slope };
-			float drive[NumLanes] = { l1Drive, l2Drive, l3Drive };
-			float feedback[NumLanes] = { l1Feedback, l2Feedback, l3Feedback };
-			float oct[NumLanes] = { l1Oct, l2Oct, l3Oct };
-			float semi[NumLanes] = { l1Semi, l2Semi, l3Semi };
-			float rmOct[NumLanes] = { l1RMOct, l2RMOct, l3RMOct };
-			float rmSemi[NumLanes] = { l1RMSemi, l2RMSemi, l3RMSemi };
-			float rmDepth[NumLanes] = { l1RMDepth, l2RMDepth, l3RMDepth };
-			float gain[NumLanes] = { l1Gain, l2Gain, l3Gain };
+			laneArgs[0] = { l1Enabled, l1Snap ? std::rint(l1Pitch) : l1Pitch, l1Resonance, l1Slope, l1Drive, l1Feedback, l1Oct, l1Semi, l1RMOct, l1RMSemi, l1RMDepth, l1Gain };
+			laneArgs[1] = { l2Enabled, l2Snap ? std::rint(l2Pitch) : l2Pitch, l2Resonance, l2Slope, l2Drive, l2Feedback, l2Oct, l2Semi, l2RMOct, l2RMSemi, l2RMDepth, l2Gain };
+			laneArgs[2] = { l3Enabled, l3Snap ? std::rint(l3Pitch) : l3Pitch, l3Resonance, l3Slope, l3Drive, l3Feedback, l3Oct, l3Semi, l3RMOct, l3RMSemi, l3RMDepth, l3Gain };
 
 			writeHead(numSamples);
-			const auto wHead = writeHead.data();
 
-			for (auto i = 0; i < NumLanes; ++i)
-			{
-				auto& lane = lanes[i];
-
-				lane
-				(
-					samples,
-					numChannels,
-					numSamples,
-					
-					enabled[i],
-					pitch[i],
-					resonance[i],
-					slope[i],
-					drive[i],
-					feedback[i],
-					oct[i],
-					semi[i],
-					rmOct[i],
-					rmSemi[i],
-					rmDepth[i],
-					gain[i],
-					
-					wHead,
-					xen
-				);
-			}
+			curSamples = samples;
+			curNumChannels = numChannels;
+			curNumSamples = numSamples;
+			curWHead = writeHead.data();
+
+			// the lanes only share the input and the write head, so they can run on different threads
+#if PPDHasLaneThreads
+			if (pool.getNumWorkers() != 0 && numSamples * numChannels >= MinSamplesParallel)
+				pool(*this, NumLanes);
+			else
+#endif
+				for (auto i = 0; i < NumLanes; ++i)
+					processTask(i);
 			
 			for (auto ch = 0; ch < numChannels; ++ch)
 				SIMD::clear(samples[ch], numSamples);
@@ -410,16 +430,52 @@ namespace audio
 				lane.addTo(samples, numChannels, numSamples);
 		}
 		
+		/* laneIdx */
+		void processTask(int i) noexcept override
+		{
+			const auto& args = laneArgs[i];
+
+			lanes[i]
+			(
+				curSamples,
+				curNumChannels,
+				curNumSamples,
+
+				args.enabled,
+				args.pitch,
+				args.resonance,
+				args.slope,
+				args.drive,
+				args.feedback,
+				args.oct,
+				args.semi,
+				args.rmOct,
+				args.rmSemi,
+				args.rmDepth,
+				args.gain,
+
+				curWHead,
+				xen
+			);
+		}
+
+		/* call when the channels stop being linked, so they continue from the processed one's state */
+		void copyFirstChannelState() noexcept
+		{
+			for (auto& lane : lanes)
+				lane.copyFirstChannelState();
+		}
+
 		void savePatch(sta::State& state)
 		{
 			for(auto l = 0; l < NumLanes; ++l)
-				lanes[l].savePatch(state, l);
+				lanes[l].savePatch(state, wtHandles[l]);
 		}
 
 		void loadPatch(sta::State& state)
 		{
 			for (auto l = 0; l < NumLanes; ++l)
-				lanes[l].loadPatch(state, l);
+				lanes[l].loadPatch(state, wtHandles[l]);
 		}
 
 		WT& getWaveTable(int laneIdx) noexcept
@@ -436,6 +492,16 @@ namespace audio
 		const XenManager& xen;
 		std::array<Lane, NumLanes> lanes;
 		WHead writeHead;
+#if PPDHasLaneThreads
+		threads::WorkerPool pool;
+		// numSamples * numChannels of the biggest block
+		int maxSamplesParallel;
+#endif
+		std::array<LaneArgs, NumLanes> laneArgs;
+		float* const* curSamples;
+		int curNumChannels, curNumSamples;
+		const int* curWHead;
+		std::array<sta::State::Handle, NumLanes> wtHandles;
 	public:
 		int delaySize;
 	};
@@ -1,4 +1,6 @@
 #include "Meter.h"
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <algorithm>
 #include <cmath>
 
 namespace audio
@@ -15,17 +17,22 @@ namespace audio
 	// Meters
 
 	Meters::Meters() :
+		interest(),
 		vals(),
 		wHead(),
+		kernels(dispatch::get()),
+		mid(nullptr),
 		lenInv(1.f),
-		length(1)
+		length(1),
+		active(false)
 	{
 	}
 
-	void Meters::prepare(float sampleRate, int blockSize)
+	void Meters::prepare(Arena& arena, float sampleRate, int blockSize)
 	{
 		length = static_cast<int>(sampleRate / PPDFPSMeters);
-		wHead.prepare(blockSize, length);
+		wHead.prepare(arena, blockSize, length);
+		mid = arena.alloc<float>(blockSize);
 		lenInv = 1.f / static_cast<float>(length);
 		for (auto& v : vals)
 			v.envFol.prepare(PPDFPSMeters);
@@ -34,6 +41,9 @@ namespace audio
 #if PPDHasGainIn
 	void Meters::processIn(const float* const* samples, int numChannels, int numSamples) noexcept
 	{
+		if (!updateActive())
+			return;
+
 		wHead(numSamples);
 
 		process(vals[Type::In], samples, numChannels, numSamples);
@@ -42,7 +52,12 @@ namespace audio
 
 	void Meters::processOut(const float* const* samples, int numChannels, int numSamples) noexcept
 	{
-#if !PPDHasGainIn
+#if PPDHasGainIn
+		if (!active)
+			return;
+#else
+		if (!updateActive())
+			return;
 		wHead(numSamples);
 #endif
 		process(vals[Type::Out], samples, numChannels, numSamples);
@@ -53,61 +68,43 @@ namespace audio
 		return vals[i].env;
 	}
 
-	void Meters::process(Val& val, const float* const* samples, int numChannels, int numSamples) noexcept
+	bool Meters::updateActive() noexcept
 	{
-		auto& rect = val.rect;
-		auto& vVal = val.val;
-		auto& envFol = val.envFol;
+		active = interest.isActive();
+		if (active && interest.checkReset())
+			reset();
+		return active;
+	}
 
-#if PPDMetersUseRMS
-		if (numChannels == 1)
+	void Meters::reset() noexcept
+	{
+		for (auto& v : vals)
 		{
-			auto smpls = samples[0];
-
-
-			for (auto s = 0; s < numSamples; ++s)
-			{
-				const auto w = wHead[s];
-
-				if (w == 0)
-				{
-					vVal = std::sqrt(rect * lenInv);
-					val.env.store(envFol.process(
-						vVal,
-						RiseInMs,
-						FallInMs
-					));
-
-					rect = 0.f;
-				}
-
-				const auto smpl = smpls[s];
-				rect += smpl * smpl;
-			}
+			v.rect = 0.f;
+			v.val = 0.f;
+			v.env.store(0.f);
+			v.envFol.reset();
 		}
+	}
+
+	void Meters::process(Val& val, const float* const* samples, int numChannels, int numSamples) noexcept
+	{
+#if PPDMetersUseRMS
+		if (numChannels == 1)
+			processRMS(val, samples[0], numSamples, 1.f);
 		else
 		{
-			for (auto s = 0; s < numSamples; ++s)
-			{
-				const auto w = wHead[s];
-
-				if (w == 0)
-				{
-					vVal = std::sqrt(rect * lenInv) * .5f;
-					val.env.store(envFol.process(
-						vVal,
-						RiseInMs,
-						FallInMs
-					));
-
-					rect = 0.f;
-				}
-
-				const auto smpl = samples[0][s] + samples[1][s];
-				rect += smpl * smpl;
-			}
+			auto m = mid;
+			juce::FloatVectorOperations::add(m, samples[0], samples[1], numSamples);
+			for (auto ch = 2; ch < numChannels; ++ch)
+				juce::FloatVectorOperations::add(m, samples[ch], numSamples);
+			processRMS(val, m, numSamples, 1.f / static_cast<float>(numChannels));
 		}
 #else
+		auto& rect = val.rect;
+		auto& vVal = val.val;
+		auto& envFol = val.envFol;
+
 		if (numChannels == 1)
 		{
 			const auto smpls = samples[0];
@@ -156,4 +153,34 @@ namespace audio
 		}
 #endif
 	}
-}
+
+	void Meters::processRMS(Val& val, const float* smpls, int numSamples, float gain) noexcept
+	{
+		auto& rect = val.rect;
+		auto& vVal = val.val;
+		auto& envFol = val.envFol;
+
+		// the window restarts whenever wHead wraps, so it can be summed in contiguous segments
+		auto s = 0;
+		while (s < numSamples)
+		{
+			const auto w = wHead[s];
+
+			if (w == 0)
+			{
+				vVal = std::sqrt(rect * lenInv) * gain;
+				val.env.store(envFol.process(
+					vVal,
+					RiseInMs,
+					FallInMs
+				));
+
+				rect = 0.f;
+			}
+
+			const auto segmentLength = std::min(numSamples - s, length - w);
+			rect += kernels.sumOfSquares(smpls + s, segmentLength);
+			s += segmentLength;
+		}
+	}
+}
\ No newline at end of file
@@ -1,8 +1,11 @@
 #pragma once
 #include "WHead.h"
 #include "EnvelopeFollower.h"
+#include "Interest.h"
+#include "../arch/Dispatch.h"
 #include <array>
 #include <atomic>
+#include <vector>
 
 namespace audio
 {
@@ -31,8 +34,8 @@ namespace audio
 	
 		Meters();
 
-		/*sampleRate, blockSize*/
-		void prepare(float, int);
+		/*arena, sampleRate, blockSize*/
+		void prepare(Arena&, float, int);
 
 #if PPDHasGainIn
 		/*samples,numChannels,numSamples*/
@@ -43,14 +46,28 @@ namespace audio
 
 		const std::atomic<float>& operator()(int i) const noexcept;
 
+		// the meters only run while someone registered for them
+		Interest interest;
 	protected:
 		std::array<Val, NumTypes> vals;
 		WHead wHead;
+		const dispatch::Kernels& kernels;
+		float* mid;
 		float lenInv;
 		int length;
+		bool active;
 
 	private:
+		/* latches the interest for this block, returns false if the meters are not needed */
+		bool updateActive() noexcept;
+
+		/* starts over from silence */
+		void reset() noexcept;
+
 		/*val,samples,numChannels,numSamples*/
 		void process(Val&, const float* const*, int, int) noexcept;
+
+		/*val,smpls,numSamples,gain*/
+		void processRMS(Val&, const float*, int, float) noexcept;
 	};
 }
@@ -2,6 +2,7 @@
 #include "../arch/Conversion.h"
 #include "../arch/Smooth.h"
 #include <juce_audio_processors/juce_audio_processors.h>
+#include "FastMath.h"
 #include "Phasor.h"
 #include <array>
 
@@ -48,7 +49,7 @@ namespace audio
 		Float synthesizeSample()
 		{
 			const auto phase = phasor().phase;
-			return std::cos(phase * Tau);
+			return math::cos(phase * Tau);
 		}
 	};
 	
@@ -1,4 +1,5 @@
 #include "Oversampling.h"
+#include <algorithm>
 #include <cmath>
 
 namespace audio
@@ -108,14 +109,18 @@ namespace audio
 		ring(),
 		ir(_ir),
 		wHead(_wHead),
+		kernels(dispatch::get()),
+		irRev(),
 		irSize(0)
 	{
 	}
 
-	void Convolver::prepare()
+	void Convolver::prepare(Arena& arena, int numChannels)
 	{
 		irSize = static_cast<int>(ir.size());
-		ring.setSize(2 + (PPDHasSidechain ? 2 : 0), irSize, false, true, false);
+		irRev.assign(ir.data(), ir.data() + irSize);
+		std::reverse(irRev.begin(), irRev.end());
+		arena.alloc(ring, numChannels, irSize);
 	}
 
 	void Convolver::processBlock(float* const* samples, int numChannels, int numSamples) noexcept
@@ -129,6 +134,12 @@ namespace audio
 		}
 	}
 
+	void Convolver::copyFirstChannelState() noexcept
+	{
+		for (auto ch = 1; ch < ring.getNumChannels(); ++ch)
+			ring.copyFrom(ch, 0, ring, 0, 0, irSize);
+	}
+
 	void Convolver::processBlock(float* smpls, float* rng, int numSamples) noexcept
 	{
 		for (auto s = 0; s < numSamples; ++s)
@@ -139,18 +150,12 @@ namespace audio
 	{
 		rng[w] = smpl;
 
-		auto y = 0.f;
-		auto r = w;
-
-		for (auto i = 0; i < irSize; ++i)
-		{
-			y += rng[r] * ir[i];
-			--r;
-			if (r == -1)
-				r = irSize - 1;
-		}
+		// the ring is read backwards from w, so the reversed ir turns it into 2 contiguous dot products
+		const auto numNewer = w + 1;
+		const auto numOlder = irSize - numNewer;
+		const auto irR = irRev.data();
 
-		return y;
+		return kernels.dot(rng, irR + numOlder, numNewer) + kernels.dot(rng + numNewer, irR, numOlder);
 	}
 
 	/////////////////////////////////////////////////////
@@ -190,9 +195,11 @@ namespace audio
 		blockSize(0),
 
 		buffer(),
+		channelsUp(nullptr),
 
 		irUp(),
 		irDown(),
+		FsIR(0.),
 		wHead(),
 
 		filterUp(irUp, wHead),
@@ -212,8 +219,10 @@ namespace audio
 		Fs(other.Fs),
 		blockSize(other.blockSize),
 		buffer(other.buffer),
+		channelsUp(other.channelsUp),
 		irUp(other.irUp),
 		irDown(other.irDown),
+		FsIR(other.FsIR),
 		wHead(other.wHead),
 		filterUp(irUp, wHead),
 		filterDown(irDown, wHead),
@@ -225,7 +234,7 @@ namespace audio
 		enbld(other.enbld)
 	{}
 
-	void Oversampler::prepare(const double sampleRate, const int _blockSize)
+	void Oversampler::prepare(Arena& arena, const double sampleRate, const int _blockSize, const int numChannels)
 	{
 		enbld = isEnabled();
 
@@ -234,19 +243,22 @@ namespace audio
 
 		if (enbld)
 		{
-			const auto numChannels = 2 + (PPDHasSidechain ? 2 : 0);
-
 			FsUp = Fs * 2.;
 			blockSizeUp = blockSize * 2;
 
-			irUp = makeWindowedSinc(static_cast<float>(FsUp), 19000.f, true);
-			irDown = makeWindowedSinc(static_cast<float>(FsUp), 19000.f, false);
+			// the filters only depend on the sample rate, so toggling hq doesn't rebuild them
+			if (FsIR != FsUp)
+			{
+				irUp = makeWindowedSinc(static_cast<float>(FsUp), 19000.f, true);
+				irDown = makeWindowedSinc(static_cast<float>(FsUp), 19000.f, false);
+				FsIR = FsUp;
+			}
 
-			filterUp.prepare();
-			filterDown.prepare();
+			filterUp.prepare(arena, numChannels);
+			filterDown.prepare(arena, numChannels);
 
-			buffer.setSize(numChannels, blockSizeUp, false, true, false);
-			wHead.prepare(blockSizeUp, static_cast<int>(irDown.size()));
+			channelsUp = arena.alloc(buffer, numChannels, blockSizeUp);
+			wHead.prepare(arena, blockSizeUp, static_cast<int>(irDown.size()));
 		}
 		else
 		{
@@ -255,16 +267,15 @@ namespace audio
 		}
 	}
 
-	AudioBuffer& Oversampler::upsample(AudioBuffer& inputBuffer) noexcept
+	AudioBuffer& Oversampler::upsample(AudioBuffer& inputBuffer, int numChannels) noexcept
 	{
 		enbld = isEnabled();
 		if (enbld)
 		{
 			numSamples1x = inputBuffer.getNumSamples();
 			numSamples2x = numSamples1x * 2;
-			const auto numChannels = inputBuffer.getNumChannels();
 
-			buffer.setSize(numChannels, numSamples2x, true, false, true);
+			buffer.setDataToReferTo(channelsUp, numChannels, numSamples2x);
 
 			auto samplesUp = buffer.getArrayOfWritePointers();
 			const auto samplesIn = inputBuffer.getArrayOfReadPointers();
@@ -280,14 +291,13 @@ namespace audio
 		return inputBuffer;
 	}
 
-	void Oversampler::downsample(AudioBuffer& outputBuffer) noexcept
+	void Oversampler::downsample(AudioBuffer& outputBuffer, int numChannels) noexcept
 	{
 		if (enbld)
 		{
 			auto samplesUp = buffer.getArrayOfWritePointers();
 			auto samplesOut = outputBuffer.getArrayOfWritePointers();
 			const auto samplesUpConst = buffer.getArrayOfReadPointers();
-			const auto numChannels = outputBuffer.getNumChannels();
 
 			// filter 2x + decimating
 			filterDown.processBlock(samplesUp, numChannels, numSamples2x);
@@ -295,6 +305,15 @@ namespace audio
 		}
 	}
 
+	void Oversampler::copyFirstChannelState() noexcept
+	{
+		if (enbld)
+		{
+			filterUp.copyFirstChannelState();
+			filterDown.copyFirstChannelState();
+		}
+	}
+
 	const int Oversampler::getLatency() const noexcept
 	{
 		if (isEnabled())
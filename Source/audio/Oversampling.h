@@ -1,5 +1,7 @@
 #pragma once
 #include "AudioUtils.h"
+#include "../arch/Dispatch.h"
+#include "Arena.h"
 #include "WHead.h"
 #include <array>
 #include <vector>
@@ -46,15 +48,21 @@ namespace audio
 	{
 		Convolver(const ImpulseResponse&, const WHead&);
 
-		void prepare();
+		/* arena, numChannels */
+		void prepare(Arena&, int);
 
 		/*samples,numChannels,numSamples*/
 		void processBlock(float* const*, int, int) noexcept;
 
+		/* copies the state of the first channel to all others */
+		void copyFirstChannelState() noexcept;
+
 	protected:
 		AudioBuffer ring;
 		const ImpulseResponse& ir;
 		const WHead& wHead;
+		const dispatch::Kernels& kernels;
+		std::vector<float> irRev;
 		int irSize;
 
 	private:
@@ -78,14 +86,17 @@ namespace audio
 
 		Oversampler(Oversampler&);
 
-		/*sampleRate,blockSize*/
-		void prepare(const double, const int);
+		/*arena,sampleRate,blockSize,numChannels*/
+		void prepare(Arena&, const double, const int, const int);
+
+		/*inputBuffer, numChannels*/
+		AudioBuffer& upsample(AudioBuffer&, int) noexcept;
 
-		/*inputBuffer*/
-		AudioBuffer& upsample(AudioBuffer&) noexcept;
+		/*outputBuffer, numChannels*/
+		void downsample(AudioBuffer&, int) noexcept;
 
-		/*outputBuffer*/
-		void downsample(AudioBuffer&) noexcept;
+		/* call when the channels stop being linked, so they continue from the processed one's state */
+		void copyFirstChannelState() noexcept;
 
 		const int getLatency() const noexcept;
 		
@@ -102,8 +113,10 @@ namespace audio
 		int blockSize;
 
 		AudioBuffer buffer;
+		float** channelsUp;
 
 		ImpulseResponse irUp, irDown;
+		double FsIR;
 		WHead wHead;
 		Convolver filterUp, filterDown;
 
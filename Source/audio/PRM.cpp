@@ -4,24 +4,32 @@ namespace audio
 {
 	PRM::PRM(float startVal) :
 		smooth(startVal),
-		buf()
+		buf(nullptr),
+		ownBuf()
 	{}
 
 	void PRM::prepare(float Fs, int blockSize, float smoothLenMs)
 	{
-		buf.resize(blockSize);
+		ownBuf.resize(blockSize);
+		buf = ownBuf.data();
+		smooth.makeFromDecayInMs(smoothLenMs, Fs);
+	}
+
+	void PRM::prepare(Arena& arena, float Fs, int blockSize, float smoothLenMs)
+	{
+		buf = arena.alloc<float>(blockSize);
 		smooth.makeFromDecayInMs(smoothLenMs, Fs);
 	}
 
 	float* PRM::operator()(float value, int numSamples) noexcept
 	{
-		smooth(buf.data(), value, numSamples);
-		return buf.data();
+		smooth(buf, value, numSamples);
+		return buf;
 	}
 
 	float* PRM::operator()(int numSamples) noexcept
 	{
-		smooth(buf.data(), numSamples);
-		return buf.data();
+		smooth(buf, numSamples);
+		return buf;
 	}
 }
\ No newline at end of file
@@ -1,5 +1,6 @@
 #pragma once
 #include "AudioUtils.h"
+#include "Arena.h"
 
 namespace audio
 {
@@ -11,6 +12,9 @@ namespace audio
 		/*Fs, blockSize, smoothLenMs */
 		void prepare(float, int, float);
 
+		/* arena, Fs, blockSize, smoothLenMs */
+		void prepare(Arena&, float, int, float);
+
 		/* value, numSamples */
 		float* operator()(float, int) noexcept;
 
@@ -18,6 +22,8 @@ namespace audio
 		float* operator()(int) noexcept;
 
 		Smooth smooth;
-		std::vector<float> buf;
+		float* buf;
+	protected:
+		std::vector<float> ownBuf;
 	};
 }
\ No newline at end of file
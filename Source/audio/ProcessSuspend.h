@@ -1,48 +1,152 @@
 #pragma once
 #include "AudioUtils.h"
+#include "Arena.h"
 
 namespace audio
 {
-	struct ProcessSuspender
+	/*
+	* one low priority thread that all plugin instances share for rebuilding their engines.
+	* hold it with a juce::SharedResourcePointer, it only runs while at least one instance exists.
+	*/
+	struct ReconfigurationThread :
+		public juce::TimeSliceThread
 	{
+		ReconfigurationThread() :
+			juce::TimeSliceThread("Manta Reconfiguration")
+		{
+			startThread(juce::Thread::Priority::low);
+		}
+
+		~ReconfigurationThread() override
+		{
+			stopThread(1000);
+		}
+	};
+
+	/*
+	* reconfigures the processor without blocking or allocating on the audio thread.
+	* the audio thread fades the wet signal out over one block and then passes the input through,
+	* while the shared reconfiguration thread calls prepareToPlay. afterwards the wet signal fades back in over one block.
+	* this is not a crossfade from the old to the new engine: the effect drops out to dry for as long
+	* as prepareToPlay takes. the engine lives in the members of the processor and its arena,
+	* so there is no second instance that could be prepared next to the running one.
+	* the audio thread never signals the thread, which polls instead while a fade out is pending.
+	*/
+	struct ProcessSuspender :
+		public juce::TimeSliceClient
+	{
+		// how often the thread looks for a finished fade out
+		static constexpr int PendingIntervalMs = 1;
+		static constexpr int IdleIntervalMs = 1000;
+
 		enum class Stage
 		{
 			Running,
-			Suspending,
+			FadingOut,
 			Suspended,
+			Preparing,
+			FadingIn,
 			NumStages
 		};
 
 		ProcessSuspender(juce::AudioProcessor& p) :
 			processor(p),
-			stage(Stage::Running)
+			thread(),
+			prepareLock(),
+			dryBuffer(),
+			stage(Stage::Running),
+			requested(false)
+		{
+			thread->addTimeSliceClient(this);
+		}
+
+		~ProcessSuspender() override
+		{
+			stop();
+		}
+
+		/* waits for a running prepare. call before the processor's members go away */
+		void stop()
 		{
+			thread->removeTimeSliceClient(this);
+		}
 
+		/* can be called from any thread but the audio thread */
+		void suspend()
+		{
+			requested.store(true);
+			thread->moveToFrontOfQueue(this);
 		}
 
-		void suspend() noexcept
+		/* arena, numChannels, blockSize. call from prepareToPlay while holding the prepare lock */
+		void prepare(Arena& arena, int numChannels, int blockSize)
 		{
-			stage.store(Stage::Suspending);
+			arena.alloc(dryBuffer, numChannels, blockSize);
 		}
 
 		/* returns true if suspending is needed (= return from processBlock) */
 		bool suspendIfNeeded(AudioBuffer& buf) noexcept
 		{
-			auto samples = buf.getArrayOfWritePointers();
-			const auto numChannels = buf.getNumChannels();
-			const auto numSamples = buf.getNumSamples();
+			auto stg = stage.load();
+			if (stg == Stage::Running && requested.exchange(false))
+			{
+				stg = Stage::FadingOut;
+				stage.store(stg);
+			}
 
-			const auto stg = stage.load();
-			if (stg == Stage::Running)
+			switch (stg)
+			{
+			case Stage::Running:
 				return false;
+			case Stage::FadingOut:
+			case Stage::FadingIn:
+				saveDry(buf);
+				return false;
+			default:
+				// the input passes through while the engine is rebuilt
+				return true;
+			}
+		}
 
-			if(numSamples != 0)
-				for (auto ch = 0; ch < numChannels; ++ch)
-					SIMD::fill(samples[ch], 0.f, numSamples);
-
-			if (stg == Stage::Suspending)
+		/* call at the end of processBlock to crossfade between the wet and the dry signal */
+		void processFade(AudioBuffer& buf) noexcept
+		{
+			const auto stg = stage.load();
+			if (stg == Stage::FadingOut)
 			{
+				fade(buf, true);
 				stage.store(Stage::Suspended);
+			}
+			else if (stg == Stage::FadingIn)
+			{
+				fade(buf, false);
+				stage.store(Stage::Running);
+			}
+		}
+
+		/* called at the end of prepareToPlay */
+		void prepareToPlay() noexcept
+		{
+			// requests that came in meanwhile are served by this prepare already
+			requested.store(false);
+			if (stage.load() == Stage::Preparing)
+				stage.store(Stage::FadingIn);
+			else
+				stage.store(Stage::Running);
+		}
+
+		juce::CriticalSection& getPrepareLock() noexcept
+		{
+			return prepareLock;
+		}
+
+		/* reconfiguration thread */
+		int useTimeSlice() override
+		{
+			if (stage.load() == Stage::Suspended)
+			{
+				const juce::ScopedLock lock(prepareLock);
+				stage.store(Stage::Preparing);
 				processor.prepareToPlay
 				(
 					processor.getSampleRate(),
@@ -50,16 +154,46 @@ namespace audio
 				);
 			}
 
-			return true;
-		}
-		
-		void prepareToPlay() noexcept
-		{
-			stage.store(Stage::Running);
+			const auto stg = stage.load();
+			const auto pending = stg == Stage::FadingOut || (stg == Stage::Running && requested.load());
+			return pending ? PendingIntervalMs : IdleIntervalMs;
 		}
 
 	protected:
 		juce::AudioProcessor& processor;
+		juce::SharedResourcePointer<ReconfigurationThread> thread;
+		juce::CriticalSection prepareLock;
+		AudioBuffer dryBuffer;
 		std::atomic<Stage> stage;
+		std::atomic<bool> requested;
+
+		void saveDry(const AudioBuffer& buf) noexcept
+		{
+			const auto numChannels = std::min(buf.getNumChannels(), dryBuffer.getNumChannels());
+			const auto numSamples = std::min(buf.getNumSamples(), dryBuffer.getNumSamples());
+			for (auto ch = 0; ch < numChannels; ++ch)
+				SIMD::copy(dryBuffer.getWritePointer(ch), buf.getReadPointer(ch), numSamples);
+		}
+
+		/* buf, toDry */
+		void fade(AudioBuffer& buf, bool toDry) noexcept
+		{
+			const auto numChannels = std::min(buf.getNumChannels(), dryBuffer.getNumChannels());
+			const auto numSamples = std::min(buf.getNumSamples(), dryBuffer.getNumSamples());
+			if (numSamples == 0)
+				return;
+			const auto inc = 1.f / static_cast<float>(numSamples);
+
+			for (auto ch = 0; ch < numChannels; ++ch)
+			{
+				const auto dry = dryBuffer.getReadPointer(ch);
+				auto smpls = buf.getWritePointer(ch);
+
+				auto x = toDry ? 0.f : 1.f;
+				const auto xInc = toDry ? inc : -inc;
+				for (auto s = 0; s < numSamples; ++s, x += xInc)
+					smpls[s] += x * (dry[s] - smpls[s]);
+			}
+		}
 	};
 }
@@ -1,54 +1,113 @@
 #pragma once
 #include "AudioUtils.h"
+#include "AnalysisThread.h"
+#include "Arena.h"
+#include "Interest.h"
 #include "XenManager.h"
+#include "../arch/TripleBuffer.h"
 #include <juce_dsp/juce_dsp.h>
 #include <array>
 
 namespace audio
 {
-	template<size_t Order>
-	struct SpectroBeam
+	/*
+	* the audio thread only sums the channels to mono and pushes them into a lock-free ring.
+	* the shared analysis thread does the windowed fft every hop and publishes magnitude spectra
+	* through triple buffers, so the editor never reads a spectrum that is being written.
+	* besides the linear bins it publishes a remap onto the note axis of the xen manager,
+	* where every point takes the loudest bin of its own note range (constant-q).
+	* nothing is analysed while no one registered interest in the spectrum.
+	*/
+	template<size_t Order, size_t Overlap = 4>
+	struct SpectroBeam :
+		public juce::TimeSliceClient
 	{
 		static constexpr size_t Size = 1 << Order;
 		static constexpr size_t Size2 = Size * 2;
 		static constexpr size_t SizeHalf = Size / 2;
+		static constexpr size_t NumBins = SizeHalf + 1;
+		static constexpr size_t Hop = Size / Overlap;
 		static constexpr float SizeF = static_cast<float>(Size);
 		static constexpr float SizeInv = 1.f / SizeF;
-		
-		
+		// resolution and range of the note axis remap
+		static constexpr size_t NumPoints = Size;
+		static constexpr float NumNotes = 128.f;
+		// room for a few analysis thread time slices at high sample rates
+		static constexpr int RingSize = static_cast<int>(Size) * 8;
+		static constexpr int AnalysisIntervalMs = 10;
+		static constexpr int IdleIntervalMs = 100;
+
 		using FFT = juce::dsp::FFT;
 		using Fifo = std::array<float, Size>;
 		using Fifo2 = std::array<float, Size2>;
+		using Spectrum = std::array<float, NumBins>;
+		using Display = std::array<float, NumPoints>;
+
+		/* where a point of the note axis reads the spectrum. lo > hi means it interpolates at binIdx */
+		struct MapPoint
+		{
+			float binIdx;
+			int lo, hi;
+		};
 
-		SpectroBeam() :
-			smpls(),
+		SpectroBeam(const XenManager& _xen) :
+			interest(),
+			xen(_xen),
+			smpls(nullptr),
+			analysisThread(),
+			ringFifo(RingSize),
+			ring(),
 			fft(Order),
-			fifo(),
+			history(),
+			frame(),
 			window(),
-			buffer(),
-			ready(false),
-			idx(0)
+			magnitudes(),
+			map(),
+			spectrum(),
+			display(),
+			sampleRate(44100.f),
+			mapSampleRate(0.f),
+			mapGeneration(-1),
+			historyIdx(0),
+			hopIdx(0)
 		{
-			SIMD::clear(buffer.data(), Size2);
-			SIMD::clear(fifo.data(), Size2);
+			SIMD::clear(history.data(), Size);
+			SIMD::clear(frame.data(), Size2);
+			SIMD::clear(magnitudes.data(), NumBins);
 
-			// gaussian window
+			// gaussian window, scaled so that a full scale sine reads 1
+			auto windowSum = 0.f;
 			for (auto i = 0; i < Size; ++i)
 			{
 				const auto norm = static_cast<float>(i) * SizeInv;
 				const auto x = norm * 2.f - 1.f;
 				const auto w = std::exp(-x * x * 16.f);
 				window[i] = w;
+				windowSum += w;
 			}
+			SIMD::multiply(window.data(), 2.f / windowSum, Size);
+
+			analysisThread->addTimeSliceClient(this);
+		}
+
+		~SpectroBeam() override
+		{
+			analysisThread->removeTimeSliceClient(this);
 		}
 
-		void prepare(int blockSize)
+		/* arena, sampleRate, blockSize */
+		void prepare(Arena& arena, float _sampleRate, int blockSize)
 		{
-			smpls.resize(blockSize);
+			sampleRate.store(_sampleRate);
+			smpls = arena.alloc<float>(blockSize);
 		}
 
+		/* samples, numChannels, numSamples. audio thread */
 		void operator()(float* const* samples, int numChannels, int numSamples) noexcept
 		{
+			if (!interest.isActive())
+				return;
+
 			const auto chInv = 1.f / numChannels;
 
 			for (auto s = 0; s < numSamples; ++s)
@@ -60,39 +119,163 @@ namespace audio
 				smpls[s] = mid;
 			}
 
-			process(numSamples);
+			push(numSamples);
 		}
 
-		void process(int numSamples) noexcept
+		/* analysis thread */
+		int useTimeSlice() override
 		{
-			auto fif = fifo.data();
-			for (auto s = 0; s < numSamples; ++s)
-			{
-				fif[idx] = smpls[s];
-				++idx;
-				if (idx == Size)
-				{
-					const auto wndw = window.data();
-					auto buf = buffer.data();
-					
-					SIMD::multiply(fif, wndw, Size);
-					fft.performRealOnlyForwardTransform(fif, true);
-					SIMD::copy(buf, fif, Size);
-					ready.store(true);
-					idx = 0;
-				}
-			}
+			if (!interest.isActive())
+				return IdleIntervalMs;
+			if (interest.checkReset())
+				reset();
+
+			int start1, size1, start2, size2;
+			ringFifo.prepareToRead(ringFifo.getNumReady(), start1, size1, start2, size2);
+			process(ring.data() + start1, size1);
+			process(ring.data() + start2, size2);
+			ringFifo.finishedRead(size1 + size2);
+
+			return AnalysisIntervalMs;
 		}
 
+		Interest interest;
 	protected:
-		std::vector<float> smpls;
+		const XenManager& xen;
+		float* smpls;
+		juce::SharedResourcePointer<AnalysisThread> analysisThread;
+		juce::AbstractFifo ringFifo;
+		std::array<float, RingSize> ring;
 		FFT fft;
-		Fifo2 fifo;
+		Fifo history;
+		Fifo2 frame;
 		Fifo window;
+		Spectrum magnitudes;
+		std::array<MapPoint, NumPoints> map;
 	public:
-		Fifo2 buffer;
-		std::atomic<bool> ready;
+		// read by the editor
+		threads::TripleBuffer<Spectrum> spectrum;
+		threads::TripleBuffer<Display> display;
 	protected:
-		int idx;
+		std::atomic<float> sampleRate;
+		float mapSampleRate;
+		int mapGeneration, historyIdx, hopIdx;
+
+		/* drops everything from before the analysis was paused */
+		void reset() noexcept
+		{
+			ringFifo.finishedRead(ringFifo.getNumReady());
+			SIMD::clear(history.data(), Size);
+			SIMD::clear(magnitudes.data(), NumBins);
+			historyIdx = 0;
+			hopIdx = 0;
+		}
+
+		/* numSamples. if the analysis thread falls behind, the samples that don't fit are dropped */
+		void push(int numSamples) noexcept
+		{
+			int start1, size1, start2, size2;
+			ringFifo.prepareToWrite(numSamples, start1, size1, start2, size2);
+			SIMD::copy(ring.data() + start1, smpls, size1);
+			SIMD::copy(ring.data() + start2, smpls + size1, size2);
+			ringFifo.finishedWrite(size1 + size2);
+		}
+
+		/* samples, numSamples */
+		void process(const float* samples, int numSamples) noexcept
+		{
+			for (auto s = 0; s < numSamples; ++s)
+			{
+				history[historyIdx] = samples[s];
+				historyIdx = (historyIdx + 1) % static_cast<int>(Size);
+				++hopIdx;
+				if (hopIdx == Hop)
+				{
+					analyse();
+					hopIdx = 0;
+				}
+			}
+		}
+
+		void analyse() noexcept
+		{
+			// unroll the history so the oldest sample comes first
+			auto fr = frame.data();
+			const auto numOlder = static_cast<int>(Size) - historyIdx;
+			SIMD::copy(fr, history.data() + historyIdx, numOlder);
+			SIMD::copy(fr + numOlder, history.data(), historyIdx);
+
+			SIMD::multiply(fr, window.data(), Size);
+			fft.performFrequencyOnlyForwardTransform(fr, true);
+
+			auto mags = magnitudes.data();
+			SIMD::copy(mags, fr, NumBins);
+
+			SIMD::copy(spectrum.getWriteBuffer().data(), mags, NumBins);
+			spectrum.publish();
+
+			remap(display.getWriteBuffer().data());
+			display.publish();
+		}
+
+		/* rebuilds the point to bin table, if the sample rate or the tuning changed since the last time */
+		void updateMap() noexcept
+		{
+			const auto sr = sampleRate.load();
+			const auto gen = xen.getGeneration();
+			if (mapSampleRate == sr && mapGeneration == gen)
+				return;
+			mapSampleRate = sr;
+			mapGeneration = gen;
+
+			const auto binsPerHz = SizeF / sr;
+			const auto xenVal = xen.getXen();
+			const auto noteStep = NumNotes / static_cast<float>(NumPoints);
+			// the distance of neighbouring points in bins grows with the frequency
+			const auto relWidth = std::exp2(noteStep / xenVal) - 1.f;
+			const auto maxBinIdx = static_cast<float>(NumBins - 2);
+
+			for (auto p = 0; p < NumPoints; ++p)
+			{
+				const auto pitch = static_cast<float>(p) * noteStep;
+				const auto freqHz = xen.noteToFreqHzWithWrap(pitch + xenVal);
+				const auto binIdx = std::min(freqHz * binsPerHz, maxBinIdx);
+				const auto widthHalf = binIdx * relWidth * .5f;
+
+				auto& m = map[p];
+				m.binIdx = binIdx;
+				if (widthHalf < 1.f)
+				{
+					m.lo = 1;
+					m.hi = 0;
+				}
+				else
+				{
+					m.lo = static_cast<int>(binIdx - widthHalf);
+					m.hi = std::min(static_cast<int>(binIdx + widthHalf), static_cast<int>(NumBins) - 1);
+				}
+			}
+		}
+
+		/* dest */
+		void remap(float* dest) noexcept
+		{
+			updateMap();
+			const auto mags = magnitudes.data();
+
+			for (auto p = 0; p < NumPoints; ++p)
+			{
+				const auto& m = map[p];
+				if (m.lo > m.hi)
+					dest[p] = interpolate::lerp(mags, m.binIdx);
+				else
+				{
+					auto y = 0.f;
+					for (auto i = m.lo; i <= m.hi; ++i)
+						y = std::max(y, mags[i]);
+					dest[p] = y;
+				}
+			}
+		}
 	};
 }
@@ -4,7 +4,8 @@ namespace audio
 {
 
 	WHead::WHead() :
-		buf(),
+		ownBuf(),
+		buf(nullptr),
 		wHead(0),
 		delaySize(1)
 	{}
@@ -15,7 +16,18 @@ namespace audio
 		if (delaySize != 0)
 		{
 			wHead = wHead % delaySize;
-			buf.resize(blockSize);
+			ownBuf.resize(blockSize);
+			buf = ownBuf.data();
+		}
+	}
+
+	void WHead::prepare(Arena& arena, int blockSize, int _delaySize)
+	{
+		delaySize = _delaySize;
+		if (delaySize != 0)
+		{
+			wHead = wHead % delaySize;
+			buf = arena.alloc<int>(blockSize);
 		}
 	}
 
@@ -32,7 +44,7 @@ namespace audio
 
 	const int* WHead::data() const noexcept
 	{
-		return buf.data();
+		return buf;
 	}
 
 }
\ No newline at end of file
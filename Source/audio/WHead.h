@@ -1,4 +1,5 @@
 #pragma once
+#include "Arena.h"
 #include <vector>
 
 namespace audio
@@ -10,6 +11,9 @@ namespace audio
 		/* blockSize, delaySize */
 		void prepare(int, int);
 
+		/* arena, blockSize, delaySize */
+		void prepare(Arena&, int, int);
+
 		/* numSamples */
 		void operator()(int numSamples) noexcept;
 
@@ -17,7 +21,8 @@ namespace audio
 
 		const int* data() const noexcept;
 	protected:
-		std::vector<int> buf;
+		std::vector<int> ownBuf;
+		int* buf;
 		int wHead, delaySize;
 	};
 }
\ No newline at end of file
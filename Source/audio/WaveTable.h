@@ -5,9 +5,15 @@
 #include "AudioUtils.h"
 #include "../arch/Interpolation.h"
 #include "../arch/State.h"
+#include "../arch/TripleBuffer.h"
 
 namespace audio
 {
+	/*
+	* the table is edited on the message thread (formulas, patches) and read by the editor from there.
+	* edits reach the audio thread as a whole through a triple buffer once they are published,
+	* so swapping the table of a playing voice never mixes the old and the new waveform.
+	*/
 	template<size_t Size>
 	struct WaveTable
 	{
@@ -15,12 +21,17 @@ namespace audio
 		static constexpr float SizeInv = 1.f / SizeF;
 		static constexpr int NumExtraSamples = 4;
 		static constexpr int FullSize = Size + NumExtraSamples;
+		// "WTQ1", marks a table saved as compressed 16 bit integers
+		static constexpr int QuantizedMagic = 0x31515457;
+		static constexpr float QuantizeMax = 32767.f;
+		static constexpr float QuantizeMaxInv = 1.f / QuantizeMax;
 
 		using Table = std::array<float, FullSize>;
 		using Func = std::function<float(float)>;
 
 		WaveTable() :
-			table()
+			table(),
+			published()
 		{
 			create([](float x) { return std::cos(x * Pi); });
 		}
@@ -33,43 +44,91 @@ namespace audio
 				table[s] = func(x);
 			for (auto i = 0; i < NumExtraSamples; ++i)
 				table[Size + i] = table[i];
+			publish();
 		}
 
-		void savePatch(sta::State& state, const String& key)
+		/* hands the edited table to the audio thread */
+		void publish() noexcept
 		{
+			published.getWriteBuffer() = table;
+			published.publish();
+		}
+
+		/* audio thread. picks up the latest published table, call once per block */
+		void update() noexcept
+		{
+			published.update();
+		}
+
+		/* state, handle. stores the table quantized to 16 bit and compressed */
+		void savePatch(sta::State& state, const sta::State::Handle& handle)
+		{
+			std::array<juce::int16, Size> quantized;
+			for (auto s = 0; s < Size; ++s)
+			{
+				const auto x = juce::jlimit(-1.f, 1.f, table[s]);
+				quantized[s] = juce::ByteOrder::swapIfBigEndian(static_cast<juce::int16>(std::rint(x * QuantizeMax)));
+			}
+
 			juce::MemoryBlock mb;
-			const auto dataSize = FullSize * sizeof(float);
-			mb.append(table.data(), dataSize);
-			const auto base64 = mb.toBase64Encoding();
-			state.set(key, "wt", base64, false);
+			{
+				juce::MemoryOutputStream out(mb, false);
+				out.writeInt(QuantizedMagic);
+				juce::GZIPCompressorOutputStream zip(out);
+				zip.write(quantized.data(), sizeof(quantized));
+			}
+			state.set(handle, mb, false);
 		}
 
-		void loadPatch(sta::State& state, const String& key)
+		/* state, handle. reads the quantized table, or the raw floats of older versions */
+		void loadPatch(sta::State& state, const sta::State::Handle& handle)
 		{
-			auto var = state.get(key, "wt");
-			if (var != nullptr)
+			auto var = state.get(handle);
+			if (var == nullptr)
+				return;
+
+			// binary in chunks, base64 in xml
+			juce::MemoryBlock mb;
+			if (auto binary = var->getBinaryData())
+				mb = *binary;
+			else
+				mb.fromBase64Encoding(var->toString());
+
+			juce::MemoryInputStream in(mb, false);
+			if (mb.getSize() > sizeof(int) && in.readInt() == QuantizedMagic)
+			{
+				std::array<juce::int16, Size> quantized;
+				juce::GZIPDecompressorInputStream zip(in);
+				if (zip.read(quantized.data(), static_cast<int>(sizeof(quantized))) != static_cast<int>(sizeof(quantized)))
+					return;
+				for (auto s = 0; s < Size; ++s)
+					table[s] = static_cast<float>(juce::ByteOrder::swapIfBigEndian(quantized[s])) * QuantizeMaxInv;
+				for (auto i = 0; i < NumExtraSamples; ++i)
+					table[Size + i] = table[i];
+				publish();
+				return;
+			}
+
+			const auto dataSize = FullSize * sizeof(float);
+			jassert(mb.getSize() == dataSize);
+			if (mb.getSize() == dataSize)
 			{
-				const auto base64 = var->toString();
-				juce::MemoryBlock mb;
-				mb.fromBase64Encoding(base64);
-#if JUCE_DEBUG
-				const auto mbSize = mb.getSize();
-#endif
-				const auto dataSize = FullSize * sizeof(float);
-				jassert(mbSize == dataSize);
 				mb.copyTo(table.data(), 0, dataSize);
+				publish();
 			}
 		}
 
+		/* idx. reads the edited table */
 		float operator()(int idx) const noexcept
 		{
 			return table[idx];
 		}
 
+		/* phase. audio thread, reads the published table */
 		float operator()(float phase) const noexcept
 		{
 			const auto idx = phase * SizeF;
-			return interpolate::lerp(table.data(), idx);
+			return interpolate::lerp(published.getReadBuffer().data(), idx);
 		}
 
 		float* data() noexcept
@@ -84,6 +143,7 @@ namespace audio
 		
 	protected:
 		Table table;
+		threads::TripleBuffer<Table> published;
 	};
 
 	template<size_t Size>
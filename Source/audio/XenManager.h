@@ -13,7 +13,8 @@ namespace audio
 			xen(12.f),
 			masterTune(440.f),
 			baseNote(69.f),
-			temperaments()
+			temperaments(),
+			generation(0)
 		{
 			for (auto& t : temperaments)
 				t = 0.f;
@@ -21,17 +22,24 @@ namespace audio
 
 		void setTemperament(float tmprVal, int noteVal) noexcept
 		{
+			const auto changed = temperaments[noteVal].load() != tmprVal;
 			temperaments[noteVal] = tmprVal;
 			const auto idx2 = noteVal + PPD_MaxXen;
 			if (idx2 >= temperaments.size())
 				temperaments[idx2] = tmprVal;
+			// after the values, so whoever sees the new generation also sees the new tuning
+			if (changed)
+				generation.fetch_add(1, std::memory_order_release);
 		}
 		
 		void operator()(float _xen, float _masterTune, float _baseNote) noexcept
 		{
-			xen = _xen;
-			masterTune = _masterTune;
-			baseNote = _baseNote;
+			const auto changed = xen.load() != _xen || masterTune.load() != _masterTune || baseNote.load() != _baseNote;
+			xen.store(_xen);
+			masterTune.store(_masterTune);
+			baseNote.store(_baseNote);
+			if (changed)
+				generation.fetch_add(1, std::memory_order_release);
 		}
 
 		template<typename Float>
@@ -40,7 +48,7 @@ namespace audio
 			const auto noteCap = juce::jlimit(static_cast<Float>(0), static_cast<Float>(PPD_MaxXen), note);
 			const auto tmprmt = temperaments[static_cast<int>(std::round(noteCap))].load();
 
-			return noteInFreqHz(note + tmprmt, baseNote, xen, masterTune);
+			return noteInFreqHz(note + static_cast<Float>(tmprmt), static_cast<Float>(baseNote.load()), static_cast<Float>(xen.load()), static_cast<Float>(masterTune.load()));
 		}
 
 		template<typename Float>
@@ -57,21 +65,29 @@ namespace audio
 		template<typename Float>
 		Float freqHzToNote(Float hz) noexcept
 		{
-			return freqHzInNote(hz, baseNote, xen, masterTune);
+			return freqHzInNote(hz, static_cast<Float>(baseNote.load()), static_cast<Float>(xen.load()), static_cast<Float>(masterTune.load()));
 		}
 		
 		float getXen() const noexcept
 		{
-			return xen;
+			return xen.load();
+		}
+
+		/* changes whenever the tuning does. lets caches of note to frequency mappings know when to rebuild */
+		int getGeneration() const noexcept
+		{
+			return generation.load(std::memory_order_acquire);
 		}
 
 	protected:
-		float xen, masterTune, baseNote;
+		std::atomic<float> xen, masterTune, baseNote;
 		std::array<std::atomic<float>, PPD_MaxXen + 1> temperaments;
+		std::atomic<int> generation;
 	};
 	
 }
 
+#include "Arena.h"
 #include "Oscillator.h"
 
 namespace audio
@@ -87,38 +103,38 @@ namespace audio
 			
 			xen(_xen),
 			osc(),
-			buffer()
+			buffer(nullptr),
+			gainHandle(getIDString(), "gain")
 		{
 
 		}
 
 		void loadPatch(sta::State& state)
 		{
-			const auto idStr = getIDString();
-			auto g = state.get(idStr, "gain");
+			auto g = state.get(gainHandle);
 			if (g != nullptr)
 				gain.store(static_cast<float>(*g));
 		}
 
 		void savePatch(sta::State& state)
 		{
-			const auto idStr = getIDString();
-			state.set(idStr, "gain", gain.load());
+			state.set(gainHandle, gain.load());
 		}
 
-		void prepare(float Fs, int blockSize)
+		/* arena, Fs, blockSize */
+		void prepare(Arena& arena, float Fs, int blockSize)
 		{
 			const auto fsInv = 1.f / Fs;
 			osc.prepare(fsInv);
 
-			buffer.resize(blockSize, 0.f);
+			buffer = arena.alloc<float>(blockSize);
 		}
 
 		void operator()(float* const* samples, int numChannels, int numSamples) noexcept
 		{
 			if (noteOn.load())
 			{
-				auto buf = buffer.data();
+				auto buf = buffer;
 
 				auto g = gain.load();
 
@@ -126,7 +142,7 @@ namespace audio
 				osc.setFreqHz(freqHz);
 
 				for (auto s = 0; s < numSamples; ++s)
-					buf[s] = std::tanh(4.f * osc()) * g;
+					buf[s] = math::tanh(4.f * osc()) * g;
 
 				for (auto ch = 0; ch < numChannels; ++ch)
 					SIMD::add(samples[ch], buf, numSamples);
@@ -138,7 +154,8 @@ namespace audio
 	protected:
 		const XenManager& xen;
 		OscSine<float> osc;
-		std::vector<float> buffer;
+		float* buffer;
+		sta::State::Handle gainHandle;
 
 		static String getIDString()
 		{
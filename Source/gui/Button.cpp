@@ -2,7 +2,8 @@
 
 namespace gui
 {
-	BlinkyBoy::BlinkyBoy() :
+	BlinkyBoy::BlinkyBoy(Utils& u) :
+		FrameTimer(u.frames),
 		comp(nullptr),
 		env(0.f),
 		inv(0.f)
@@ -125,12 +126,17 @@ namespace gui
 			}
 		});
 
-		onTimer.push_back([this](Button&)
+		onTimer.push_back([this, generation = 0u](Button&) mutable
 		{
 			bool shallRepaint = false;
 
 			const auto param = utils.getParam(pID[0]);
 
+			const auto gen = param->getGeneration();
+			if (generation == gen)
+				return;
+			generation = gen;
+
 			const auto lckd = param->isLocked();
 			if (locked != lckd)
 			{
@@ -165,11 +171,12 @@ namespace gui
 
 	Button::Button(Utils& _utils, String&& _tooltip, Notify&& _notify) :
 		Comp(_utils, _tooltip, std::move(_notify)),
+		FrameTimer(_utils.frames, this),
 		onClick(),
 		onTimer(),
 		onPaint(),
 		onMouseWheel(),
-		blinkyBoy(),
+		blinkyBoy(_utils),
 		toggleState(-1),
 		pID(),
 		locked(false),
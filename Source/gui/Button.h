@@ -5,9 +5,9 @@ namespace gui
 {
 
 	struct BlinkyBoy :
-		public Timer
+		public FrameTimer
 	{
-		BlinkyBoy();
+		BlinkyBoy(Utils&);
 
 		void init(Comp* _comp, float timeInSecs) noexcept;
 
@@ -22,7 +22,7 @@ namespace gui
 
 	struct Button :
 		public Comp,
-		public Timer
+		public FrameTimer
 	{
 		using OnClick = std::function<void(Button&, const Mouse&)>;
 		using OnTimer = std::function<void(Button&)>;
@@ -111,6 +111,7 @@ namespace gui
 	
 	CompWidgetable::CompWidgetable(Utils& u, String&& _tooltip, CursorType _cursorType) :
 		Comp(u, std::move(_tooltip), _cursorType),
+		FrameTimer(u.frames),
 		bounds0(),
 		bounds1(),
 		widgetEnvelope(0.f),
@@ -120,6 +121,7 @@ namespace gui
 
 	CompWidgetable::CompWidgetable(Utils& u, String&& _tooltip, Notify&& _notify, CursorType _cursorType) :
 		Comp(u, std::move(_tooltip), std::move(_notify), _cursorType),
+		FrameTimer(u.frames),
 		bounds0(),
 		bounds1(),
 		widgetEnvelope(0.f),
@@ -52,7 +52,7 @@ namespace gui
 
 	struct CompWidgetable :
 		public Comp,
-		public Timer
+		public FrameTimer
 	{
 		CompWidgetable(Utils&, String&& /*_tooltip*/, CursorType = CursorType::Interact);
 		
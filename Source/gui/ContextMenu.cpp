@@ -138,6 +138,7 @@ namespace gui
 					{
 						auto param = u.getParam(pID);
 						param->setDefaultValue(param->getValue());
+						param->saveDefaultValue(u.getProps());
 					}
 				}, 2);
 				pop.setButton([&u = utils, pIDs](Button&, const Mouse&)
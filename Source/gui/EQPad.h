@@ -6,7 +6,7 @@ namespace gui
 {
 	class EQPad :
 		public Comp,
-		public Timer
+		public FrameTimer
 	{
 		enum Tool { Select, Move, NumTools };
 	public:
@@ -141,6 +141,7 @@ namespace gui
 		
 		EQPad(Utils& u, String&& _tooltip) :
 			Comp(u, _tooltip, CursorType::Interact),
+			FrameTimer(u.frames, this),
 			bounds(),
 			onSelectionChanged(),
 			
@@ -2,25 +2,29 @@
 
 namespace gui
 {
-	//FilterResponseGraph
-
 	FilterResponseGraph::FilterResponseGraph(Utils& u) :
 		Comp(u, "", CursorType::Default),
+		FrameTimer(u.frames, this),
 		responseCurveCID(ColourID::Hover),
-		processFilters(nullptr),
-		needsUpdate(nullptr),
-
-		impulse(),
-		processBuffer(),
-		dftBuffer(),
-
-		responseCurve()
+		shallUpdate(),
+		getLanes(),
+		analysisThread(),
+		requests(),
+		results(),
+		response(),
+		responseCurve(),
+		fcTable(),
+		fcTableFs(0.f),
+		fcTableGen(-1)
 	{
-		SIMD::clear(impulse.data(), Size);
-		impulse[0] = 1.f;
-
 		setInterceptsMouseClicks(false, false);
-		startTimerHz(4);
+		analysisThread->addTimeSliceClient(this);
+		startTimerHz(PPDFPSKnobs);
+	}
+
+	FilterResponseGraph::~FilterResponseGraph()
+	{
+		analysisThread->removeTimeSliceClient(this);
 	}
 
 	void FilterResponseGraph::paint(Graphics& g)
@@ -34,132 +38,96 @@ namespace gui
 		g.strokePath(responseCurve, stroke);
 	}
 
-	void FilterResponseGraph::resized()
-	{
-		if (responseCurve.isEmpty())
-			return;
-
-		updateResponseCurve();
-	}
-
 	void FilterResponseGraph::timerCallback()
 	{
-		if (needsUpdate())
+		// evaluated first, so that shallUpdate always takes its snapshot of the parameters
+		const auto paramsChanged = shallUpdate();
+		if (updateFcTable() || paramsChanged)
+			requestUpdate();
+
+		if (results.update())
 		{
 			updateResponseCurve();
 			repaint();
 		}
 	}
 
-	void FilterResponseGraph::updateResponseCurve()
-	{
-		resetBuffers();
-
-		processFilters(processBuffer.data(), impulse, Size);
-
-		applyForwardDFT();
-
-		generateResponseCurve();
-	}
-
-	void FilterResponseGraph::resetBuffers()
+	void FilterResponseGraph::resized()
 	{
-		SIMD::clear(processBuffer.data(), processBuffer.size());
-
-		for (auto& d : dftBuffer)
-			d = { 0.f, 0.f };
+		updateFcTable();
+		requestUpdate();
 	}
 
-	void FilterResponseGraph::applyForwardDFT()
+	int FilterResponseGraph::useTimeSlice()
 	{
-		auto buf = processBuffer.data();
-		auto dft = dftBuffer.data();
-
-		for (auto n = 0; n < Size; ++n)
-		{
-			const auto f = Pi * static_cast<float>(n) * SizeInv;
-			auto real = 0.f;
-			auto imag = 0.f;
-			for (auto s = 0; s < Size; ++s)
-			{
-				const auto sf = s * f;
-				real += buf[s] * std::cos(sf);
-				imag -= buf[s] * std::sin(sf);
-			}
-			dft[n] += std::complex<float>{ real, imag };
-		}
-
-		for (auto i = 0; i < Size; ++i)
-			buf[i] = std::abs(dft[i]);
+		if (!requests.update())
+			return IdleIntervalMs;
+
+		const auto& request = requests.getReadBuffer();
+		const auto numPoints = static_cast<int>(request.fcs.size());
+		auto& result = results.getWriteBuffer();
+		result.mags.resize(numPoints);
+
+		response
+		(
+			result.mags.data(), request.fcs.data(), numPoints,
+			request.lanes.data(), static_cast<int>(request.lanes.size())
+		);
+
+		results.publish();
+		return IdleIntervalMs;
 	}
 
-	void FilterResponseGraph::generateResponseCurve()
+	bool FilterResponseGraph::updateFcTable()
 	{
-		const auto thicc = utils.thicc;
-		const auto w = static_cast<float>(getWidth());
-		const auto h = static_cast<float>(getHeight());
-		const auto wInv = 1.f / w;
-		const auto buf = processBuffer.data();
+		const auto width = getWidth();
 		const auto& xen = utils.audioProcessor.xenManager;
-		const auto fsInv = 1.f / static_cast<float>(utils.audioProcessor.getSampleRate());
-
-		responseCurve.clear();
+		const auto Fs = static_cast<float>(utils.audioProcessor.getSampleRate());
+		const auto gen = xen.getGeneration();
+		if (fcTable.size() == static_cast<size_t>(width) && fcTableFs == Fs && fcTableGen == gen)
+			return false;
+		fcTableFs = Fs;
+		fcTableGen = gen;
+		fcTable.resize(width);
+
+		const auto wInv = 1.f / static_cast<float>(width);
+		const auto fsInv = 1.f / Fs;
+
+		for (auto x = 0; x < width; ++x)
 		{
-			const auto y = h - h * buf[0];
-			responseCurve.startNewSubPath(0.f, y);
-		}
-		for (auto x = thicc; x < w; x += 1.f)
-		{
-			const auto r = x * wInv;
-			const auto pitch = r * 128.f;
-			const auto freqHz = xen.noteToFreqHzWithWrap(pitch + xen.getXen());
-			const auto fc = freqHz * fsInv;
-			const auto idx = fc * SizeF;
-
-			auto y = h - h * interpolate::lerp(buf, idx);
-			y = juce::jlimit(0.f, h, y);
-
-			responseCurve.lineTo(x, y);
+			const auto pitch = static_cast<float>(x) * wInv * 128.f;
+			fcTable[x] = xen.noteToFreqHzWithWrap(pitch) * fsInv;
 		}
-		responseCurve.lineTo(w, h - h * buf[Size - 1]);
-	}
-
-	//FilterResponseGraph2
-
-	FilterResponseGraph2::FilterResponseGraph2(Utils& u) :
-		Comp(u, "", CursorType::Default),
-		responseCurveCID(ColourID::Hover),
-		shallUpdate(),
-		update(),
-		responseCurve()
-	{
-		setInterceptsMouseClicks(false, false);
-		startTimerHz(PPDFPSKnobs);
+		return true;
 	}
 
-	void FilterResponseGraph2::paint(Graphics& g)
+	void FilterResponseGraph::requestUpdate()
 	{
-		if (responseCurve.isEmpty())
-			return;
-		const auto thicc = utils.thicc;
-		const Stroke stroke(thicc, Stroke::PathStrokeType::JointStyle::curved, Stroke::PathStrokeType::EndCapStyle::rounded);
+		auto& request = requests.getWriteBuffer();
+		request.fcs = fcTable;
+		getLanes(request.lanes);
+		requests.publish();
 
-		g.setColour(Colours::c(responseCurveCID));
-		g.strokePath(responseCurve, stroke);
+		analysisThread->moveToFrontOfQueue(this);
 	}
 
-	void FilterResponseGraph2::timerCallback()
-	{
-		if (shallUpdate())
-			resized();
-	}
-
-	void FilterResponseGraph2::resized()
+	void FilterResponseGraph::updateResponseCurve()
 	{
+		const auto& mags = results.getReadBuffer().mags;
+		const auto numPoints = static_cast<int>(mags.size());
 		const auto w = static_cast<float>(getWidth());
 		const auto h = static_cast<float>(getHeight());
+		// the result might still be from before the last resize
+		const auto xScale = numPoints == 0 ? 0.f : w / static_cast<float>(numPoints);
 
-		update(responseCurve, w, h);
-		repaint();
+		responseCurve.clear();
+		responseCurve.startNewSubPath(0.f, h);
+		for (auto i = 0; i < numPoints; ++i)
+		{
+			const auto mag = mags[i];
+			const auto y = h - h * juce::jlimit(0.f, 1.f, std::isnan(mag) ? 0.f : mag);
+			responseCurve.lineTo(static_cast<float>(i) * xScale, y);
+		}
+		responseCurve.lineTo(w, h);
 	}
-}
\ No newline at end of file
+}
@@ -1,75 +1,72 @@
 #pragma once
 #include "Comp.h"
 #include <functional>
-#include <array>
-#include <complex>
+#include <vector>
+#include "../arch/TripleBuffer.h"
+#include "../audio/AnalysisThread.h"
+#include "../audio/FilterResponse.h"
 #include "../audio/XenManager.h"
 
 namespace gui
 {
+	/*
+	* draws the combined response of the lanes on the note axis of the xen manager.
+	* when the parameters change, the response is evaluated on the shared analysis thread,
+	* so that dragging a lane doesn't stall the message thread. the curve follows once it's ready.
+	*/
 	struct FilterResponseGraph :
 		public Comp,
-		public Timer
+		public FrameTimer,
+		public juce::TimeSliceClient
 	{
-		using Complex = std::complex<float>;
-		
-#if JUCE_DEBUG
-		static constexpr int Size = 1 << 10;
-#else
-		static constexpr int Size = 1 << 12;
-#endif
-		static constexpr float SizeF = static_cast<float>(Size);
-		static constexpr float SizeInv = 1.f / SizeF;
-
-		using Buffer = std::array<float, Size>;
-		using DFTBuffer = std::array<Complex, Size>;
+		using Lanes = std::vector<audio::FilterResponse::Lane>;
+		static constexpr int IdleIntervalMs = 100;
 
 		FilterResponseGraph(Utils&);
 
-		void paint(Graphics&) override;
+		~FilterResponseGraph() override;
 
-		void resized() override;
+		void paint(Graphics&) override;
 
 		void timerCallback() override;
 
-		void updateResponseCurve();
+		void resized() override;
+
+		/* analysis thread */
+		int useTimeSlice() override;
 
 		ColourID responseCurveCID;
-		/* samples, impulse, numSamples */
-		std::function<void(float*, Buffer&, int)> processFilters;
-		std::function<bool()> needsUpdate;
+		std::function<bool()> shallUpdate;
+		/* lanes. describes every lane at the current sample rate */
+		std::function<void(Lanes&)> getLanes;
 	protected:
-		Buffer impulse;
-		Buffer processBuffer;
-		DFTBuffer dftBuffer;
-
+		struct Request
+		{
+			std::vector<float> fcs;
+			Lanes lanes;
+		};
+
+		struct Result
+		{
+			std::vector<float> mags;
+		};
+
+		juce::SharedResourcePointer<audio::AnalysisThread> analysisThread;
+		threads::TripleBuffer<Request> requests;
+		threads::TripleBuffer<Result> results;
+		audio::FilterResponse response;
 		Path responseCurve;
+		// normalized frequency of every pixel
+		std::vector<float> fcTable;
+		float fcTableFs;
+		int fcTableGen;
 
-		void resetBuffers();
-		
-		void applyForwardDFT();
-
-		void generateResponseCurve();
-
-	};
-
-	struct FilterResponseGraph2 :
-		public Comp,
-		public Timer
-	{
-		FilterResponseGraph2(Utils&);
-
-		void paint(Graphics&) override;
-
-		void timerCallback();
+		/* rebuilds the pixel to frequency table if the width, sample rate or tuning changed. returns true if it did */
+		bool updateFcTable();
 
-		void resized() override;
+		/* hands the current parameters to the analysis thread */
+		void requestUpdate();
 
-		ColourID responseCurveCID;
-		std::function<bool()> shallUpdate;
-		/* responseCurve, width, height */
-		std::function<void(Path&, float, float)> update;
-	protected:
-		Path responseCurve;
+		void updateResponseCurve();
 	};
-}
\ No newline at end of file
+}
@@ -21,7 +21,8 @@ namespace gui
 			TextEditor(u, _tooltip, "enter some math"),
 			postFX{ false, false, false },
 			fx(),
-			updateFormula()
+			updateFormula(),
+			onUpdate([]() {})
 		{
 			onReturn = [this, tables, size, overshoot]()
 			{
@@ -85,6 +86,10 @@ namespace gui
 				auto numTables = tables.size();
 				for (auto i = 1; i < numTables; ++i)
 					SIMD::copy(tables[i], tables[0], fullSize);
+
+				// the tables are part of the patch
+				utils.audioProcessor.state.markDirty();
+				onUpdate();
 			};
 
 			setInterceptsMouseClicks(true, true);
@@ -96,6 +101,8 @@ namespace gui
 		std::array<bool, NumPostFX> postFX;
 		Parser fx;
 		std::function<void()> updateFormula;
+		// called after the tables were written
+		std::function<void()> onUpdate;
 	};
 
 	struct FormulaParser2 :
@@ -0,0 +1,99 @@
+#include "FrameScheduler.h"
+
+namespace gui
+{
+	FrameTimer::FrameTimer(FrameScheduler& _scheduler, const Component* _comp) :
+		scheduler(_scheduler),
+		comp(_comp),
+		intervalMs(0.),
+		nextMs(0.),
+		running(false)
+	{
+		scheduler.add(this);
+	}
+
+	FrameTimer::~FrameTimer()
+	{
+		scheduler.remove(this);
+	}
+
+	void FrameTimer::startTimerHz(int fps) noexcept
+	{
+		if (fps <= 0)
+		{
+			stopTimer();
+			return;
+		}
+
+		intervalMs = 1000. / static_cast<double>(fps);
+		nextMs = Time::getMillisecondCounterHiRes() + intervalMs;
+		running = true;
+	}
+
+	void FrameTimer::stopTimer() noexcept
+	{
+		running = false;
+	}
+
+	bool FrameTimer::isTimerRunning() const noexcept
+	{
+		return running;
+	}
+
+	FrameScheduler::FrameScheduler(Component& top) :
+		vblank(&top, [this]() { onVBlank(); }),
+		timers(),
+		iterating(false),
+		hasGaps(false)
+	{
+	}
+
+	void FrameScheduler::add(FrameTimer* timer)
+	{
+		timers.push_back(timer);
+	}
+
+	void FrameScheduler::remove(FrameTimer* timer)
+	{
+		const auto it = std::find(timers.begin(), timers.end(), timer);
+		if (it == timers.end())
+			return;
+
+		// callbacks may destroy components, the list is compacted after the frame
+		if (iterating)
+		{
+			*it = nullptr;
+			hasGaps = true;
+		}
+		else
+			timers.erase(it);
+	}
+
+	void FrameScheduler::onVBlank()
+	{
+		const auto now = Time::getMillisecondCounterHiRes();
+
+		iterating = true;
+		// timers created by callbacks are added to the end and run in the same frame
+		for (auto i = 0; i < timers.size(); ++i)
+		{
+			auto timer = timers[i];
+			if (timer == nullptr || !timer->running)
+				continue;
+			if (now < timer->nextMs - ToleranceMs)
+				continue;
+			if (timer->comp != nullptr && !timer->comp->isShowing())
+				continue;
+
+			timer->nextMs = std::max(timer->nextMs + timer->intervalMs, now);
+			timer->timerCallback();
+		}
+		iterating = false;
+
+		if (hasGaps)
+		{
+			timers.erase(std::remove(timers.begin(), timers.end(), nullptr), timers.end());
+			hasGaps = false;
+		}
+	}
+}
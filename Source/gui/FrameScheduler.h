@@ -0,0 +1,63 @@
+#pragma once
+#include "Using.h"
+
+namespace gui
+{
+	class FrameScheduler;
+
+	/*
+	* the periodic callback of a component, like a juce::Timer, but driven by the frame scheduler of the editor.
+	* with a component it is only called while the component is showing.
+	*/
+	class FrameTimer
+	{
+		friend class FrameScheduler;
+	public:
+		/* scheduler, comp (nullptr = also while not showing) */
+		FrameTimer(FrameScheduler&, const Component* = nullptr);
+
+		virtual ~FrameTimer();
+
+		/* fps. the rate is approximated by the frames of the display */
+		void startTimerHz(int) noexcept;
+
+		void stopTimer() noexcept;
+
+		bool isTimerRunning() const noexcept;
+
+		virtual void timerCallback() = 0;
+
+	private:
+		FrameScheduler& scheduler;
+		const Component* comp;
+		double intervalMs, nextMs;
+		bool running;
+	};
+
+	/*
+	* one per editor. calls all frame timers from the vblank of the editor's display,
+	* instead of each component running its own juce::Timer.
+	* timers that are not due yet and the ones of components that are not showing are skipped,
+	* and while the editor isn't on screen there are no vblanks, so nothing runs at all.
+	*/
+	class FrameScheduler
+	{
+		friend class FrameTimer;
+		// vblanks come with some jitter, so timers are called if they are almost due
+		static constexpr double ToleranceMs = 2.;
+	public:
+		/* top. the component whose display paces the frames */
+		FrameScheduler(Component&);
+
+	private:
+		juce::VBlankAttachment vblank;
+		std::vector<FrameTimer*> timers;
+		bool iterating, hasGaps;
+
+		void add(FrameTimer*);
+
+		void remove(FrameTimer*);
+
+		void onVBlank();
+	};
+}
@@ -6,6 +6,7 @@ namespace gui
 
     Knob::Knob(Utils& u, const String& _name, const String& _tooltip, CursorType _cursorType) :
         Comp(u, _tooltip, _cursorType),
+        FrameTimer(u.frames, this),
         onEnter([](Knob&) {}),
         onExit([](Knob&) {}),
         onDown([](Knob&) {}),
@@ -492,6 +493,7 @@ namespace gui
             const auto newValue = juce::jlimit(0.f, 1.f, param->load() - dragOffset.y * speed);
             param->store(newValue);
             k.values[0] = newValue;
+            k.getUtils().audioProcessor.state.markDirty();
 
             k.label.setText(String(newValue, 2));
             repaintWithChildren(&k);
@@ -513,6 +515,8 @@ namespace gui
                         param->store(.25f);
 
             const auto newValue = param->load();
+            if (k.values[0] != newValue)
+                k.getUtils().audioProcessor.state.markDirty();
             k.values[0] = newValue;
             k.label.setText(String(newValue, 2));
             repaintWithChildren(&k);
@@ -523,6 +527,7 @@ namespace gui
             const auto newValue = juce::jlimit(0.f, 1.f, param->load() + k.dragXY.y);
             param->store(newValue);
             k.values[0] = newValue;
+            k.getUtils().audioProcessor.state.markDirty();
 
             k.label.setText(String(newValue, 2));
             repaintWithChildren(&k);
@@ -533,6 +538,7 @@ namespace gui
             const auto dVal = .25f;
             param->store(dVal);
             k.values[0] = dVal;
+            k.getUtils().audioProcessor.state.markDirty();
 
             k.label.setText(String(dVal, 2));
             repaintWithChildren(&k);
@@ -727,29 +733,35 @@ namespace gui
         values.emplace_back(mainParam->getModBias());
         values.emplace_back(0.f);
 
-        knob.onTimer = [mainParam, meter](Knob& k)
+        knob.onTimer = [mainParam, meter, generation = 0u](Knob& k) mutable
         {
 			bool hasMeter = meter != nullptr;
             bool shallRepaint = false;
+            auto& vals = k.values;
 
-            const auto lckd = mainParam->isLocked();
-            if (k.locked != lckd)
-                k.setLocked(lckd);
+            // the parameter only needs a look if it changed since the last frame
+            const auto gen = mainParam->getGeneration();
+            if (generation != gen)
+            {
+                generation = gen;
 
-            const auto vn = mainParam->getValue();
-            const auto mmd = mainParam->getMaxModDepth();
-            const auto vm = mainParam->getValMod();
-            const auto mb = mainParam->getModBias();
+                const auto lckd = mainParam->isLocked();
+                if (k.locked != lckd)
+                    k.setLocked(lckd);
 
-            auto& vals = k.values;
+                const auto vn = mainParam->getValue();
+                const auto mmd = mainParam->getMaxModDepth();
+                const auto vm = mainParam->getValMod();
+                const auto mb = mainParam->getModBias();
 
-            if (vals[looks::Value] != vn || vals[looks::MaxModDepth] != mmd || vals[looks::ValMod] != vm || vals[looks::ModBias] != mb)
-            {
-                vals[looks::Value] = vn;
-                vals[looks::MaxModDepth] = mmd;
-                vals[looks::ValMod] = vm;
-                vals[looks::ModBias] = mb;
-                shallRepaint = true;
+                if (vals[looks::Value] != vn || vals[looks::MaxModDepth] != mmd || vals[looks::ValMod] != vm || vals[looks::ModBias] != mb)
+                {
+                    vals[looks::Value] = vn;
+                    vals[looks::MaxModDepth] = mmd;
+                    vals[looks::ValMod] = vm;
+                    vals[looks::ModBias] = mb;
+                    shallRepaint = true;
+                }
             }
 
             if (hasMeter)
@@ -958,6 +970,7 @@ namespace gui
                     {
                         auto param = btn.getUtils().getParam(pID);
                         param->setDefaultValue(param->getValue());
+                        param->saveDefaultValue(btn.getUtils().getProps());
                     }
                 }, 3);
                 pop.setButton([pIDs](Button& btn, const Mouse&)
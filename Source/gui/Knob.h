@@ -7,7 +7,7 @@ namespace gui
 {
     struct Knob :
         public Comp,
-        public Timer
+        public FrameTimer
     {
         using Func = std::function<void(Knob&)>;
         using OnDrag = std::function<void(Knob&, PointF&, bool)>;
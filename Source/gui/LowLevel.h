@@ -15,7 +15,8 @@ namespace gui
     {
         static constexpr int NumLanes = audio::Manta::NumLanes;
 		static constexpr int ParamsPerLane = audio::Manta::NumParametersPerLane;
-        static constexpr int NumParamsUsedInEQPad = 6;
+        // enabled, pitch, resonance, slope, gain, pitch-snap, feedback, delay-oct, delay-semi
+        static constexpr int NumParamsUsedInGraph = 9;
 
         LowLevel(Utils& u) :
             Comp(u, "", CursorType::Default),
@@ -40,93 +41,67 @@ namespace gui
                 {
                     auto offset = l * ParamsPerLane;
 
-                    const auto nEnabled = utils.getParam(PID::Lane1Enabled, offset)->getValMod();
-                    const auto nPitch = utils.getParam(PID::Lane1Pitch, offset)->getValModDenorm();
-                    const auto nResonance = utils.getParam(PID::Lane1Resonance, offset)->getValModDenorm();
-                    const auto nSlope = std::round(utils.getParam(PID::Lane1Slope, offset)->getValModDenorm());
-                    const auto nGain = audio::decibelToGain(utils.getParam(PID::Lane1Gain, offset)->getValModDenorm());
-					const auto nPitchSnap = utils.getParam(PID::Lane1PitchSnap, offset)->getValMod();
-
-                    offset = l * NumParamsUsedInEQPad;
-                    const auto i0 = offset;
-                    const auto i1 = 1 + offset;
-                    const auto i2 = 2 + offset;
-                    const auto i3 = 3 + offset;
-                    const auto i4 = 4 + offset;
-					const auto i5 = 5 + offset;
-
-                    if (filterParams[i0] != nEnabled
-                        || filterParams[i1] != nPitch
-                        || filterParams[i2] != nResonance
-                        || filterParams[i3] != nSlope
-                        || filterParams[i4] != nGain
-						|| filterParams[i5] != nPitchSnap)
+                    const std::array<float, NumParamsUsedInGraph> nParams =
                     {
-                        filterParams[i0] = nEnabled;
-                        filterParams[i1] = nPitch;
-                        filterParams[i2] = nResonance;
-                        filterParams[i3] = nSlope;
-                        filterParams[i4] = nGain;
-						filterParams[i5] = nPitchSnap;
-
-                        needsUpdate = true;
+                        utils.getParam(PID::Lane1Enabled, offset)->getValMod(),
+                        utils.getParam(PID::Lane1Pitch, offset)->getValModDenorm(),
+                        utils.getParam(PID::Lane1Resonance, offset)->getValModDenorm(),
+                        std::round(utils.getParam(PID::Lane1Slope, offset)->getValModDenorm()),
+                        audio::decibelToGain(utils.getParam(PID::Lane1Gain, offset)->getValModDenorm()),
+                        utils.getParam(PID::Lane1PitchSnap, offset)->getValMod(),
+                        utils.getParam(PID::Lane1Feedback, offset)->getValModDenorm(),
+                        utils.getParam(PID::Lane1DelayOct, offset)->getValModDenorm(),
+                        utils.getParam(PID::Lane1DelaySemi, offset)->getValModDenorm()
+                    };
+
+                    offset = l * NumParamsUsedInGraph;
+                    for (auto i = 0; i < NumParamsUsedInGraph; ++i)
+                    {
+                        if (filterParams[offset + i] != nParams[i])
+                        {
+                            filterParams[offset + i] = nParams[i];
+                            needsUpdate = true;
+                        }
                     }
                 }
 
                 return needsUpdate;
             };
-            filterResponseGraph.update = [&](Path& responseCurve, float w, float h)
+            filterResponseGraph.getLanes = [&](FilterResponseGraph::Lanes& lanes)
             {
                 const auto Fs = static_cast<float>(utils.audioProcessor.getSampleRate());
-                const auto fsInv = 1.f / Fs;
-				
-                auto& xen = utils.audioProcessor.xenManager;
-
-                audio::FilterBandpassSlope<4> fltr;
-                responseCurve.clear();
-                responseCurve.startNewSubPath(0.f, h);
-                for (auto x = 0.f; x < w; ++x)
-                {
-                    const auto f = x / w;
-
-                    const auto pitch = f * 128.f;
-                    const auto freqHz = xen.noteToFreqHzWithWrap(pitch);
-                    const auto rIdx = freqHz * fsInv;
-
-                    auto mag = 0.f;
-                    for (auto l = 0; l < NumLanes; ++l)
-                    {
-                        const auto offset = l * NumParamsUsedInEQPad;
-                        const auto i0 = offset;
-                        const auto i1 = 1 + offset;
-                        const auto i2 = 2 + offset;
-                        const auto i3 = 3 + offset;
-                        const auto i4 = 4 + offset;
-						const auto i5 = 5 + offset;
-
-                        const auto nEnabled = filterParams[i0];
-                        auto nPitch = filterParams[i1]; 
-                        const auto nQ = filterParams[i2];
-                        const auto nSlope = filterParams[i3];
-                        const auto nGain = filterParams[i4];
-						const auto nPitchSnap = filterParams[i5];
-
-                        if (nPitchSnap > .5f)
-							nPitch = std::round(nPitch);
-						
-						const auto nFc = xen.noteToFreqHzWithWrap(nPitch) * fsInv;
-                        const auto g = std::round(nEnabled) * nGain;
-
-                        fltr.setStage(static_cast<int>(nSlope));
-                        fltr.setFc(nFc, nQ);
-                        mag += std::abs(fltr.response(rIdx)) * g;
-                    }
+                const auto& xen = utils.audioProcessor.xenManager;
+                const auto xenVal = xen.getXen();
 
-                    const auto y = h - h * juce::jlimit(0.f, 1.f, std::isnan(mag) ? 0.f : mag);
-
-                    responseCurve.lineTo(x, y);
+                lanes.resize(Fs > 0.f ? NumLanes : 0);
+                for (auto l = 0; l < static_cast<int>(lanes.size()); ++l)
+                {
+                    const auto params = filterParams.data() + l * NumParamsUsedInGraph;
+                    const auto nEnabled = params[0];
+                    auto nPitch = params[1];
+                    const auto nQ = params[2];
+                    const auto nSlope = params[3];
+                    const auto nGain = params[4];
+                    const auto nPitchSnap = params[5];
+                    const auto nFeedback = params[6];
+                    const auto nOct = params[7];
+                    const auto nSemi = params[8];
+
+                    if (nPitchSnap > .5f)
+                        nPitch = std::round(nPitch);
+
+                    // the same frequencies as in Manta::Lane
+                    const auto delayPitch = nPitch + nOct * xenVal + nSemi;
+
+                    auto& lane = lanes[l];
+                    lane.enabled = nEnabled > .5f;
+                    lane.fc = audio::freqHzInFc(xen.noteToFreqHzWithWrap(nPitch, 20.f), Fs);
+                    lane.q = nQ;
+                    lane.slope = static_cast<int>(nSlope);
+                    lane.feedback = nFeedback;
+                    lane.delaySamples = audio::freqHzInSamples(xen.noteToFreqHzWithWrap(delayPitch, 5.f), Fs);
+                    lane.gain = nGain;
                 }
-                responseCurve.lineTo(w, h);
             };
 			
             addAndMakeVisible(eqPad);
@@ -168,9 +143,9 @@ namespace gui
     protected:
         EQPad eqPad;
         SpectroBeamComp<11> spectroBeam;
-        FilterResponseGraph2 filterResponseGraph;
+        FilterResponseGraph filterResponseGraph;
         MantaComp manta;
 		
-        std::array<float, NumLanes * NumParamsUsedInEQPad> filterParams;
+        std::array<float, NumLanes * NumParamsUsedInGraph> filterParams;
     };
 }
\ No newline at end of file
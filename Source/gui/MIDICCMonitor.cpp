@@ -4,6 +4,7 @@ namespace gui
 {
 	MIDICCMonitor::MIDICCMonitor(Utils& u, const Learn& _learn) :
 		Comp(u, "Monitors your input controller number for MIDI Learn.", CursorType::Default),
+		FrameTimer(u.frames, this),
 		learn(_learn),
 		idx(learn.ccIdx.load()),
 		label(u, idx < 0 ? "cc: .." : toString())
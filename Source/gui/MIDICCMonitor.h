@@ -6,7 +6,7 @@ namespace gui
 {
 	struct MIDICCMonitor :
 		public Comp,
-		public Timer
+		public FrameTimer
 	{
 		using Learn = audio::MIDILearn;
 
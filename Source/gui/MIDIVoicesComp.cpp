@@ -4,6 +4,7 @@ namespace gui
 {
 	MIDIVoicesComp::MIDIVoicesComp(Utils& u) :
 		Comp(u, "MIDI Voices", CursorType::Default),
+		FrameTimer(u.frames, this),
 		voices(u.getMIDIVoicesArray())
 #if PPD_MIDINumVoices > 0
 		, voicesActive()
@@ -5,7 +5,7 @@ namespace gui
 {
 	struct MIDIVoicesComp :
 		public Comp,
-		public Timer
+		public FrameTimer
 	{
 		MIDIVoicesComp(Utils&);
 
@@ -263,13 +263,16 @@ namespace gui
 
 					{
 						std::vector<float*> tables;
+						std::vector<int> tableIdxs;
 						tables.reserve(numSelected);
+						tableIdxs.reserve(numSelected);
 						for (auto i = 0; i < numSelected; ++i)
 						{
 							const auto pID = selected[i]->morePIDs[7];
 							const auto tableIdx = pID == PID::Lane1RMDepth ? 0 :
 								pID == PID::Lane2RMDepth ? 1 : 2;
 							tables.emplace_back(u.audioProcessor.manta.getWaveTable(tableIdx).data());
+							tableIdxs.push_back(tableIdx);
 						}
 						
 						wtParser = std::make_unique<FormulaParser2>
@@ -281,6 +284,12 @@ namespace gui
 							audio::WaveTable<WTSize>::NumExtraSamples
 						);
 						
+						wtParser->parser.onUpdate = [&u, tableIdxs]()
+						{
+							for (const auto tableIdx : tableIdxs)
+								u.audioProcessor.manta.getWaveTable(tableIdx).publish();
+						};
+
 						auto oR = wtParser->parser.onReturn;
 						wtParser->parser.onReturn = [&, oR]()
 						{
@@ -18,6 +18,7 @@ namespace gui
 
 	ColourSelector::ColourSelector(Utils& u) :
 		Comp(u, "", CursorType::Default),
+		FrameTimer(u.frames, this),
 		selector(!CS::showAlphaChannel | CS::showColourAtTop | !CS::showSliders | CS::showColourspace, 4, 7),
 		revert(u, "Click here to revert to the last state of your coloursheme."),
 		deflt(u, "Click here to set the coloursheme back to its default state."),
@@ -91,7 +92,7 @@ namespace gui
 
 	ErkenntnisseComp::ErkenntnisseComp(Utils& u) :
 		Comp(u, "", CursorType::Default),
-		Timer(),
+		FrameTimer(u.frames, this),
 		editor(u, "Enter or edit wisdom.", "Enter wisdom..."),
 		date(u, ""),
 		manifest(u, "Click here to manifest wisdom to the manifest of wisdom!"),
@@ -148,7 +148,7 @@ namespace gui
 
 	struct ColourSelector :
 		public Comp,
-		public Timer
+		public FrameTimer
 	{
 		using CS = juce::ColourSelector;
 
@@ -168,7 +168,7 @@ namespace gui
 
 	struct ErkenntnisseComp :
 		public Comp,
-		public Timer
+		public FrameTimer
 	{
 		ErkenntnisseComp(Utils&);
 
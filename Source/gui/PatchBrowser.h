@@ -1,6 +1,9 @@
 #pragma once
 #include "TextEditor.h"
 #include "../arch/State.h"
+#include "../arch/PatchBank.h"
+#include "../arch/PatchIndex.h"
+#include "../arch/PatchSearch.h"
 
 #define DebugNumPatches 0
 
@@ -28,49 +31,45 @@ namespace gui
 
 	inline String getFileName(const String& name, const String& author)
 	{
-		return author + "_-_" + name + ".patch";
+		return sta::PatchIndex::getFileName(name, author);
 	}
 
-	struct Patch :
-		public Button
+	/* what the browser knows about a patch */
+	struct Patch
 	{
 		/* constructor for making temporary patches */
-		Patch(Utils& u, const String& _name, const String& _author) :
-			Button(u, "Click on this patch in order to select it."),
-			name(u, _name),
-			author(u, _author),
-			file()
+		Patch(const String& _name, const String& _author) :
+			name(_name),
+			author(_author),
+			file(),
+			tags(),
+			bankIdx(-1),
+			searchID(-1),
+			scanned(true)
 		{
 		}
 
-		/* constructor for reading patch from file */
-		Patch(Utils& u, const File& _file) :
-			Button(u, "Click on this patch in order to select it."),
-			name(u, ""),
-			author(u, ""),
-			file(_file)
+		/* constructor for patches found by the index */
+		Patch(const sta::PatchIndex::Entry& entry) :
+			name(entry.name),
+			author(entry.author),
+			file(entry.file),
+			tags(entry.tags),
+			bankIdx(entry.bankIdx),
+			searchID(-1),
+			scanned(true)
 		{
-			const auto fileName = file.getFileNameWithoutExtension();
-			// for instance: user_-_best patch ever.patch
-			for (auto i = 0; i < fileName.length(); ++i)
-			{
-				const auto chr = fileName[i];
-				if(chr == '_')
-					if (fileName.substring(i, i + 3) == "_-_")
-					{
-						author.setText(fileName.substring(0, i));
-						name.setText(fileName.substring(i + 3));
-					}
-			}
-			init();
 		}
 
 		/* constructor for saving patch from plugin state */
-		Patch(Utils& u, const String& _name, const String& _author, const ValueTree& vt) :
-			Button(u, "Click on this patch in order to select it."),
-			name(u, _name),
-			author(u, _author),
-			file()
+		Patch(Utils& utils, const String& _name, const String& _author, const ValueTree& vt) :
+			name(_name),
+			author(_author),
+			file(),
+			tags(vt.getProperty("tags").toString()),
+			bankIdx(-1),
+			searchID(-1),
+			scanned(true)
 		{
 			const auto directory = getDirectory(utils.getProps());
 			file = File(directory.getFullPathName() + "\\" + getFileName(_name, _author));
@@ -78,14 +77,12 @@ namespace gui
 			if (file.exists())
 				file.deleteFile();
 			file.appendText(vt.toXmlString());
-
-			init();
 		}
 
 		bool operator==(const Patch& other) const noexcept
 		{
-			return other.name.getText() == name.getText()
-				&& other.author.getText() == author.getText();
+			return other.name == name
+				&& other.author == author;
 		}
 
 		bool operator!=(const Patch& other) const noexcept
@@ -95,22 +92,34 @@ namespace gui
 
 		bool isRemovable() const
 		{
-			return author.getText() != "factory";
-		}
-
-		void resized() override
-		{
-			layout.resized();
-
-			layout.place(name, 1, 0, 1, 1, false);
-			layout.place(author, 2, 0, 1, 1, false);
+			return author != "factory" && bankIdx == -1;
 		}
 
-		Label name, author;
+		String name, author;
 		File file;
+		String tags;
+		// record in the bank, if file is a patch bank
+		int bankIdx;
+		// document of this patch in the search
+		int searchID;
+		// false from the start of a rescan until the index lists the patch again
+		bool scanned;
+	};
 
-	protected:
-		void init()
+	inline String getFileName(const Patch& patch)
+	{
+		return getFileName(patch.name, patch.author);
+	}
+
+	/* one visible line of the patch list. rows are reused for other patches while scrolling */
+	struct PatchRow :
+		public Button
+	{
+		PatchRow(Utils& u) :
+			Button(u, "Click on this patch in order to select it."),
+			name(u, ""),
+			author(u, ""),
+			patchIdx(-1)
 		{
 			layout.init(
 				{ 1, PatchNameWidth, PatchAuthorWidth, 1 },
@@ -134,25 +143,62 @@ namespace gui
 			addAndMakeVisible(name);
 			addAndMakeVisible(author);
 		}
-	};
 
-	inline String getFileName(const Patch& patch)
-	{
-		return getFileName(patch.name.getText(), patch.author.getText());
-	}
+		/* patch, patchIdx, selected */
+		void show(const Patch& patch, int _patchIdx, bool selected)
+		{
+			const auto ts = selected ? 1 : 0;
+			if (patchIdx == _patchIdx && toggleState == ts)
+				return;
+
+			patchIdx = _patchIdx;
+			toggleState = ts;
+			name.setText(patch.name);
+			author.setText(patch.author);
+			repaint();
+		}
+
+		void resized() override
+		{
+			layout.resized();
+
+			layout.place(name, 1, 0, 1, 1, false);
+			layout.place(author, 2, 0, 1, 1, false);
+		}
+
+		Label name, author;
+		// the patch this row shows, -1 if none
+		int patchIdx;
+	};
 
 	static constexpr float PatchRelHeight = 8.f;
 
+	/*
+	* the patches are plain data, only the rows that fit into the list are components.
+	* what is listed, and in which order, is a permutation of patch indices,
+	* so neither sorting nor searching moves or creates components.
+	*/
 	struct Patches :
-		public CompScrollable
+		public CompScrollable,
+		public FrameTimer
 	{
-		using UniquePatch = std::unique_ptr<Patch>;
-		using SortFunc = std::function<bool(const UniquePatch&, const UniquePatch&)>;
+		using SortFunc = std::function<bool(const Patch&, const Patch&)>;
 
 		Patches(Utils& u) :
 			CompScrollable(u),
+			FrameTimer(u.frames, this),
 			patches(),
-			listBounds()
+			order(),
+			rows(),
+			patchesByID(),
+			patchesByFileName(),
+			banks(),
+			search(),
+			sortFunc(),
+			listBounds(),
+			selected(-1),
+			queryIdx(0),
+			searching(false)
 		{
 			layout.init
 			(
@@ -168,10 +214,8 @@ namespace gui
 
 		int getIdx(const Patch& nPatch) const noexcept
 		{
-			for (auto i = 0; i < numPatches(); ++i)
-				if (nPatch == *patches[i])
-					return i;
-			return -1;
+			const auto it = patchesByFileName.find(getFileName(nPatch));
+			return it == patchesByFileName.end() ? -1 : it->second;
 		}
 
 		bool contains(const Patch& nPatch) const noexcept
@@ -186,170 +230,166 @@ namespace gui
 
 			const auto auth = author.isEmpty() ? "user" : author;
 
-			Patch nPatch(utils, name, auth);
-
-			if (contains(nPatch))
+			if (contains({ name, auth }))
 				return false;
 
-			patches.push_back(std::make_unique<Patch>(utils, name, auth, utils.savePatch()));
-			auto& patch = *patches.back();
-
-			patch.onClick.push_back([&list = patches](Button& btn, const Mouse&)
-			{
-				for (auto& p : list)
-					p->toggleState = 0;
+			addPatch({ utils, name, auth, utils.savePatch() });
+			order.push_back(static_cast<int>(patches.size()) - 1);
+			select(static_cast<int>(patches.size()) - 1);
+			repaint();
 
-				btn.toggleState = 1;
-			});
+			return true;
+		}
 
-			patch.onClick.push_back([&, &file = patch.file](Button& btn, const Mouse&)
-			{
-				auto& utils = btn.utils;
-				const auto stream = file.createInputStream();
-				if (stream != nullptr)
-				{
-					const auto vt = ValueTree::fromXml(stream->readEntireStreamAsString());
-					utils.loadPatch(vt);
-					notify(EvtType::PatchUpdated, nullptr);
-				}
-			});
+		/* entry. a patch that is known already takes over where the entry found it */
+		bool add(const sta::PatchIndex::Entry& entry)
+		{
+			Patch nPatch(entry);
 
-			patch.onMouseWheel.push_back([&](Button&, const Mouse& mouse, const MouseWheel& wheel)
+			const auto idx = getIdx(nPatch);
+			if (idx != -1)
 			{
-				mouseWheelMove(mouse, wheel);
-			});
-
-			addAndMakeVisible(patch);
-			select(&patch);
+				update(patches[idx], entry);
+				return false;
+			}
 
-			resized();
-			repaintWithChildren(this);
+			addPatch(std::move(nPatch));
 
 			return true;
 		}
 
-		bool add(const File& file)
+		/* entries. new patches show up once the search had a look at them */
+		void add(const std::vector<sta::PatchIndex::Entry>& entries)
 		{
-			Patch nPatch(utils, file);
-
-			if (contains(nPatch))
-				return false;
-
-			patches.push_back(std::make_unique<Patch>(utils, file));
-			auto& patch = *patches.back();
-
-			patch.onClick.push_back([&list = patches](Button& btn, const Mouse&)
-			{
-				for (auto& p : list)
-					p->toggleState = 0;
+			for (const auto& entry : entries)
+				add(entry);
+			if (!searching)
+				showAll();
+		}
 
-				btn.toggleState = 1;
-			});
+		/* call before scanning again. patches the scan doesn't find anymore get removed by endRescan */
+		void beginRescan()
+		{
+			for (auto& patch : patches)
+				patch.scanned = false;
+		}
 
-			patch.onClick.push_back([&, &file = patch.file](Button& btn, const Mouse&)
+		void endRescan()
+		{
+			std::vector<int> newIdx(patches.size(), -1);
+			auto numKept = 0;
+			for (auto i = 0; i < numPatches(); ++i)
 			{
-				auto& utils = btn.getUtils();
-				const auto stream = file.createInputStream();
-				if (stream != nullptr)
-				{
-					const auto vt = ValueTree::fromXml(stream->readEntireStreamAsString());
-					utils.loadPatch(vt);
-					notify(EvtType::PatchUpdated, nullptr);
-				}
-			});
+				if (patches[i].scanned)
+					newIdx[i] = numKept++;
+				else
+					search.remove(patches[i].searchID);
+			}
+			if (static_cast<size_t>(numKept) == numPatches())
+				return;
 
-			patch.onMouseWheel.push_back([&](Button&, const Mouse& mouse, const MouseWheel& wheel)
+			patches.erase(std::remove_if(patches.begin(), patches.end(), [](const Patch& patch)
 			{
-				mouseWheelMove(mouse, wheel);
-			});
-
-			addAndMakeVisible(patch);
-			select(&patch);
-
-			return true;
+				return !patch.scanned;
+			}), patches.end());
+
+			std::vector<int> newOrder;
+			newOrder.reserve(order.size());
+			for (const auto o : order)
+				if (newIdx[o] != -1)
+					newOrder.push_back(newIdx[o]);
+			order = std::move(newOrder);
+			if (selected != -1)
+				selected = newIdx[selected];
+			reindex();
+
+			updateList();
 		}
 
 		bool removeSelected()
 		{
-			const auto directory = getDirectory(utils.getProps());
-
-			auto selected = getSelected();
-
-			if(selected != nullptr && selected->isRemovable())
-				for (auto i = 0; i < patches.size(); ++i)
-				{
-					const auto& patch = *patches[i];
-
-					if (patch == *selected)
-					{
-						select(nullptr);
+			auto patch = getSelected();
+			if (patch == nullptr || !patch->isRemovable())
+				return false;
 
-						const File file(directory.getFullPathName() + "\\" + getFileName(patch));
-						if (file.existsAsFile())
-							file.deleteFile();
+			const auto directory = getDirectory(utils.getProps());
+			const File file(directory.getFullPathName() + "\\" + getFileName(*patch));
+			if (file.existsAsFile())
+				file.deleteFile();
 
-						patches.erase(patches.begin() + i);
+			const auto idx = selected;
+			selected = -1;
+			search.remove(patch->searchID);
+			patches.erase(patches.begin() + idx);
 
-						resized();
-						repaintWithChildren(this);
+			// everything behind the removed patch moves one index down
+			order.erase(std::remove(order.begin(), order.end(), idx), order.end());
+			for (auto& o : order)
+				if (o > idx)
+					--o;
+			reindex();
 
-						return true;
-					}
-				}
-					
-			return false;
+			updateList();
+			return true;
 		}
 
-		bool select(Patch* nPatch) noexcept
+		/* patchIdx, -1 for none */
+		bool select(int patchIdx)
 		{
-			for (auto& p : patches)
-				p->toggleState = 0;
-
-			if (nPatch == nullptr)
-				return false;
-
-			for (auto& ptchs : patches)
-				if (*ptchs == *nPatch)
-				{
-					nPatch->toggleState = 1;
-					return true;
-				}
-
-			return false;
+			selected = patchIdx >= 0 && patchIdx < numPatches() ? patchIdx : -1;
+			layoutRows();
+			return selected != -1;
 		}
 
 		int getSelectedIdx() const noexcept
 		{
-			for (auto i = 0; i < numPatches(); ++i)
-				if (patches[i]->toggleState == 1)
-					return i;
-			return -1;
+			return selected;
 		}
 
 		const Patch* getSelected() const noexcept
 		{
-			auto idx = getSelectedIdx();
-			if (idx == -1)
+			if (selected == -1)
 				return nullptr;
-			return patches[idx].get();
+			return &patches[selected];
 		}
 
-		Patch& back() noexcept { return *patches.back(); }
+		Patch& back() noexcept { return patches.back(); }
 
-		const Patch& back() const noexcept { return *patches.back(); }
+		const Patch& back() const noexcept { return patches.back(); }
 
-		Patch& operator[](int i) noexcept { return *patches[i]; }
+		Patch& operator[](int i) noexcept { return patches[i]; }
 
-		const Patch& operator[](int i) const noexcept { return *patches[i]; }
+		const Patch& operator[](int i) const noexcept { return patches[i]; }
 
 		size_t numPatches() const noexcept { return patches.size(); }
 
-		void sort(const SortFunc& sortFunc)
+		/* the patch files of the listed patches, in the order they are listed in */
+		juce::Array<File> getListedFiles() const
 		{
-			std::sort(patches.begin(), patches.end(), sortFunc);
-			
-			resized();
-			repaintWithChildren(this);
+			juce::Array<File> files;
+			for (const auto idx : order)
+				if (patches[idx].bankIdx == -1)
+					files.add(patches[idx].file);
+			return files;
+		}
+
+		/* bank. unmaps the bank, so it can be replaced and gets opened again when needed */
+		void closeBank(const File& file)
+		{
+			banks.erase(file.getFullPathName());
+		}
+
+		void closeBanks()
+		{
+			banks.clear();
+		}
+
+		/* sortFunc. sorts the list, the patches themselves keep their indices */
+		void sort(const SortFunc& _sortFunc)
+		{
+			sortFunc = _sortFunc;
+			sortOrder();
+			updateList();
 		}
 
 		void resized() override
@@ -360,47 +400,212 @@ namespace gui
 
 			listBounds = layout(0, 0, 1, 1);
 
-			const auto x = listBounds.getX();
-			const auto w = listBounds.getWidth();
-			const auto h = utils.thicc * PatchRelHeight;
-			actualHeight = h * static_cast<float>(numPatches());
+			layoutRows();
+		}
 
-			auto y = listBounds.getY() - yScrollOffset;
+		/* text. the results of the search replace the list while they arrive */
+		void applyFilters(const String& text)
+		{
+			queryIdx = search.query(text);
+			searching = text.trim().isNotEmpty();
 
-			for (auto p = 0; p < numPatches(); ++p)
+			if (searching)
+				startTimerHz(30);
+			else
 			{
-				auto& patch = *patches[p];
+				stopTimer();
+				showAll();
+			}
+		}
 
-				if (patch.isVisible())
+		void timerCallback() override
+		{
+			if (!search.results.update())
+				return;
+
+			const auto& result = search.results.getReadBuffer();
+			if (result.queryIdx != queryIdx)
+				return;
+
+			order.clear();
+			for (const auto id : result.ids)
+			{
+				const auto patch = patchesByID.find(id);
+				if (patch != patchesByID.end())
+					order.push_back(patch->second);
+			}
+			updateList();
+		}
+
+	protected:
+		std::vector<Patch> patches;
+		// the listed patches as indices into patches, in the order they are listed in
+		std::vector<int> order;
+		std::vector<std::unique_ptr<PatchRow>> rows;
+		std::unordered_map<int, int> patchesByID;
+		std::unordered_map<String, int> patchesByFileName;
+		// opened when one of their patches gets loaded
+		std::unordered_map<String, std::unique_ptr<sta::PatchBank>> banks;
+		sta::PatchSearch search;
+		SortFunc sortFunc;
+		BoundsF listBounds;
+		int selected;
+		juce::uint32 queryIdx;
+		bool searching;
+
+		/* patch */
+		void addPatch(Patch&& patch)
+		{
+			patch.searchID = search.add(patch.name, patch.author, patch.tags);
+			const auto idx = static_cast<int>(patches.size());
+			patchesByID[patch.searchID] = idx;
+			patchesByFileName[getFileName(patch)] = idx;
+			patches.push_back(std::move(patch));
+		}
+
+		/* patch. reads the state from the patch file or decodes it from the bank */
+		ValueTree loadState(const Patch& patch)
+		{
+			if (patch.bankIdx == -1)
+			{
+				const auto stream = patch.file.createInputStream();
+				if (stream == nullptr)
+					return {};
+				return ValueTree::fromXml(stream->readEntireStreamAsString());
+			}
+
+			auto& bank = banks[patch.file.getFullPathName()];
+			if (bank == nullptr)
+			{
+				bank = std::make_unique<sta::PatchBank>();
+				if (!bank->open(patch.file))
 				{
-					patch.setBounds(BoundsF(x, y, w, h).toNearestInt());
-					y += h;
+					banks.erase(patch.file.getFullPathName());
+					return {};
 				}
 			}
+			return bank->getPatch(patch.bankIdx);
 		}
 
-		void applyFilters(const String& text)
+		/* patch, entry. a rewritten bank can hold the patch in another record, or with other tags */
+		void update(Patch& patch, const sta::PatchIndex::Entry& entry)
 		{
-			if (text.isEmpty())
+			patch.file = entry.file;
+			patch.bankIdx = entry.bankIdx;
+			patch.scanned = true;
+			if (patch.tags == entry.tags)
+				return;
+
+			const auto idx = patchesByID[patch.searchID];
+			patchesByID.erase(patch.searchID);
+			search.remove(patch.searchID);
+			patch.tags = entry.tags;
+			patch.searchID = search.add(patch.name, patch.author, patch.tags);
+			patchesByID[patch.searchID] = idx;
+		}
+
+		/* rebuilds the lookups after patches moved */
+		void reindex()
+		{
+			patchesByID.clear();
+			patchesByFileName.clear();
+			for (auto i = 0; i < numPatches(); ++i)
 			{
-				for (auto& patch : patches)
-					patch->setVisible(true);
+				patchesByID[patches[i].searchID] = i;
+				patchesByFileName[getFileName(patches[i])] = i;
 			}
-			else
+			for (auto& row : rows)
+				row->patchIdx = -1;
+		}
+
+		void showAll()
+		{
+			order.resize(numPatches());
+			for (auto i = 0; i < order.size(); ++i)
+				order[i] = i;
+			sortOrder();
+			updateList();
+		}
+
+		void sortOrder()
+		{
+			if (!sortFunc)
+				return;
+
+			std::stable_sort(order.begin(), order.end(), [&](int a, int b)
 			{
-				const auto txt = text.toLowerCase();
+				return sortFunc(patches[a], patches[b]);
+			});
+		}
 
-				for (auto& patch : patches)
-					patch->setVisible(patch->name.getText().toLowerCase().contains(txt));
-			}
-			
-			resized();
-			repaintWithChildren(this);
+		void updateList()
+		{
+			layoutRows();
+			repaint();
 		}
 
-	protected:
-		std::vector<UniquePatch> patches;
-		BoundsF listBounds;
+		PatchRow& addRow()
+		{
+			rows.push_back(std::make_unique<PatchRow>(utils));
+			auto& row = *rows.back();
+
+			row.onClick.push_back([&](Button& btn, const Mouse&)
+			{
+				const auto patchIdx = static_cast<PatchRow&>(btn).patchIdx;
+				if (patchIdx == -1)
+					return;
+
+				select(patchIdx);
+
+				const auto vt = loadState(patches[patchIdx]);
+				if (vt.isValid())
+				{
+					utils.loadPatch(vt);
+					notify(EvtType::PatchUpdated, nullptr);
+				}
+			});
+
+			row.onMouseWheel.push_back([&](Button&, const Mouse& mouse, const MouseWheel& wheel)
+			{
+				mouseWheelMove(mouse, wheel);
+			});
+
+			addChildComponent(row);
+			return row;
+		}
+
+		/* gives the rows the bounds and patches of the part of the list that is scrolled into view */
+		void layoutRows()
+		{
+			const auto h = utils.thicc * PatchRelHeight;
+			actualHeight = h * static_cast<float>(order.size());
+			if (h <= 0.f)
+				return;
+
+			const auto x = listBounds.getX();
+			const auto w = listBounds.getWidth();
+			const auto first = static_cast<int>(yScrollOffset / h);
+			const auto numRows = static_cast<int>(std::ceil(listBounds.getHeight() / h)) + 1;
+
+			while (rows.size() < numRows)
+				addRow();
+
+			for (auto r = 0; r < rows.size(); ++r)
+			{
+				auto& row = *rows[r];
+				const auto listIdx = first + r;
+				if (r < numRows && listIdx < order.size())
+				{
+					const auto patchIdx = order[listIdx];
+					const auto y = listBounds.getY() + static_cast<float>(listIdx) * h - yScrollOffset;
+					row.setBounds(BoundsF(x, y, w, h).toNearestInt());
+					row.show(patches[patchIdx], patchIdx, patchIdx == selected);
+					row.setVisible(true);
+				}
+				else
+					row.setVisible(false);
+			}
+		}
 
 		void paint(Graphics& g) override
 		{
@@ -422,14 +627,18 @@ namespace gui
 
 		void paintList(Graphics& g)
 		{
+			auto r = utils.thicc * PatchRelHeight;
+			if (r <= 0.f)
+				return;
 			auto x = listBounds.getX();
-			auto y = listBounds.getY() - yScrollOffset;
 			auto w = listBounds.getWidth();
 			auto btm = listBounds.getBottom();
-			auto r = utils.thicc * PatchRelHeight;
+			// only the stripes that are scrolled into view
+			auto i = static_cast<int>(yScrollOffset / r);
+			auto y = listBounds.getY() + static_cast<float>(i) * r - yScrollOffset;
 
 			g.setColour(Colours::c(ColourID::Txt).withAlpha(.1f));
-			for (auto i = 0; i < numPatches(); ++i)
+			for (; i < order.size(); ++i)
 			{
 				if (y >= btm)
 					return;
@@ -444,7 +653,6 @@ namespace gui
 	struct PatchesSortable :
 		public Comp
 	{
-		using UniquePatch = Patches::UniquePatch;
 		using SortFunc = Patches::SortFunc;
 
 		PatchesSortable(Utils& u) :
@@ -468,10 +676,10 @@ namespace gui
 				{
 					btn.toggleState = btn.toggleState == 0 ? 1 : 0;
 
-					SortFunc sortFunc = [&ts = btn.toggleState](const UniquePatch& a, const UniquePatch& b)
+					SortFunc sortFunc = [&ts = btn.toggleState](const Patch& a, const Patch& b)
 					{
-						const auto& pA = a->name.getText();
-						const auto& pB = b->name.getText();
+						const auto& pA = a.name;
+						const auto& pB = b.name;
 
 						if (ts == 1)
 							return pA.compareNatural(pB) > 0;
@@ -486,10 +694,10 @@ namespace gui
 				{
 					btn.toggleState = btn.toggleState == 0 ? 1 : 0;
 
-					SortFunc sortFunc = [&ts = btn.toggleState](const UniquePatch& a, const UniquePatch& b)
+					SortFunc sortFunc = [&ts = btn.toggleState](const Patch& a, const Patch& b)
 					{
-						const auto& pA = a->author.getText();
-						const auto& pB = b->author.getText();
+						const auto& pA = a.author;
+						const auto& pB = b.author;
 
 						if (ts == 1)
 							return pA.compareNatural(pB) > 0;
@@ -535,9 +743,14 @@ namespace gui
 			return patches.save(name, author);
 		}
 
-		bool add(const File& file)
+		bool add(const sta::PatchIndex::Entry& entry)
+		{
+			return patches.add(entry);
+		}
+
+		void add(const std::vector<sta::PatchIndex::Entry>& entries)
 		{
-			return patches.add(file);
+			patches.add(entries);
 		}
 
 		bool removeSelected()
@@ -545,9 +758,10 @@ namespace gui
 			return patches.removeSelected();
 		}
 
-		bool select(Patch* nPatch) noexcept
+		/* patchIdx, -1 for none */
+		bool select(int patchIdx)
 		{
-			return patches.select(nPatch);
+			return patches.select(patchIdx);
 		}
 
 		int getSelectedIdx() const noexcept
@@ -570,6 +784,31 @@ namespace gui
 
 		size_t numPatches() const noexcept { return patches.numPatches(); }
 
+		juce::Array<File> getListedFiles() const
+		{
+			return patches.getListedFiles();
+		}
+
+		void closeBank(const File& file)
+		{
+			patches.closeBank(file);
+		}
+
+		void beginRescan()
+		{
+			patches.beginRescan();
+		}
+
+		void endRescan()
+		{
+			patches.endRescan();
+		}
+
+		void closeBanks()
+		{
+			patches.closeBanks();
+		}
+
 		void sort(const SortFunc& sortFunc)
 		{
 			patches.sort(sortFunc);
@@ -615,19 +854,30 @@ namespace gui
 	};
 	
 	struct PatchBrowser :
-		public CompScreenshotable
+		public CompScreenshotable,
+		public FrameTimer
 	{
+		// patches that get added to the list per timer callback while the index streams them in
+		static constexpr size_t PatchesPerCallback = 64;
+
 		PatchBrowser(Utils& u) :
 			CompScreenshotable(u),
+			// keeps pulling from the index while closed, so the list is complete when it opens
+			FrameTimer(u.frames),
 
 			closeButton(u, "Click here to close the browser."),
 			saveButton(u, "Click here to save this patch."),
 			removeButton(u, "Click here to remove this patch."),
+			bankButton(u, "Click here to export the listed patches into a bank. Shift-click to import the patches of a bank."),
 
 			patches(u),
 
 			searchBar(u, "Define a name or search for a patch!", "Init.."),
-			authorEditor(u, "Define your author name if you want to save a patch!", "Author..")
+			authorEditor(u, "Define your author name if you want to save a patch!", "Author.."),
+
+			index(),
+			indexed(),
+			fileChooser(nullptr)
 		{
 			setInterceptsMouseClicks(true, true);
 			
@@ -639,12 +889,12 @@ namespace gui
 				const auto pathStr = getPatchesPath(user);
 				const File directory(pathStr);
 				directory.createDirectory();
-				loadPatchesFromDisk(directory);
+				scanPatches();
 			}
 
 			layout.init
 			(
-				{ 1, 3, 34, 13, 3, 3, 1 },
+				{ 1, 3, 34, 13, 3, 3, 3, 1 },
 				{ 1, 3, 34, 21, 1 }
 			);
 
@@ -684,9 +934,20 @@ namespace gui
 				removePatch();
 			});
 
+			makeTextButton(bankButton, "bank", false);
+			bankButton.getLabel().mode = Label::Mode::TextToLabelBounds;
+			bankButton.onClick.push_back([&](Button&, const Mouse& mouse)
+			{
+				if (mouse.mods.isShiftDown())
+					importBank();
+				else
+					exportBank();
+			});
+
 			addAndMakeVisible(closeButton);
 			addAndMakeVisible(saveButton);
 			addAndMakeVisible(removeButton);
+			addAndMakeVisible(bankButton);
 			addAndMakeVisible(searchBar);
 			addAndMakeVisible(authorEditor);
 			addAndMakeVisible(patches);
@@ -717,7 +978,7 @@ namespace gui
 								);
 				});
 
-			patches.select(nullptr);
+			patches.select(-1);
 
 #if DebugNumPatches != 0
 			Random rand;
@@ -766,11 +1027,12 @@ namespace gui
 			layout.place(closeButton, 1, 1, 1, 1, true);
 			layout.place(saveButton, 4, 1, 1, 1, true);
 			layout.place(removeButton, 5, 1, 1, 1, true);
+			layout.place(bankButton, 6, 1, 1, 1, true);
 			
 			layout.place(searchBar, 2, 1, 1, 1, false);
 			layout.place(authorEditor, 3, 1, 1, 1, false);
 			
-			layout.place(patches, 1, 2, 5, 2, false);
+			layout.place(patches, 1, 2, 6, 2, false);
 
 		}
 
@@ -778,18 +1040,102 @@ namespace gui
 		{
 			const auto patch = patches.getSelected();
 			if (patch != nullptr)
-				return patch->name.getText();
+				return patch->name;
 			return "init";
 		}
 
 	protected:
 		Button closeButton;
-		Button saveButton, removeButton;
+		Button saveButton, removeButton, bankButton;
 
 		PatchesSortable patches;
 
 		TextEditor searchBar, authorEditor;
 
+		sta::PatchIndex index;
+		std::vector<sta::PatchIndex::Entry> indexed;
+		std::unique_ptr<FileChooser> fileChooser;
+
+		void scanPatches()
+		{
+			const auto directory = getDirectory(utils.getProps());
+			// banks might have been replaced since they got mapped
+			patches.closeBanks();
+			patches.beginRescan();
+			index.scan(directory, directory.getChildFile("patches.index"));
+			startTimerHz(30);
+		}
+
+		void exportBank()
+		{
+			const auto directory = getDirectory(utils.getProps());
+			fileChooser = std::make_unique<FileChooser>(
+				"Export Patch Bank",
+				directory.getChildFile("bank.patchbank"),
+				"*.patchbank"
+			);
+
+			using Flag = juce::FileBrowserComponent::FileChooserFlags;
+			const auto flags = Flag::saveMode
+				+ Flag::canSelectFiles
+				+ Flag::warnAboutOverwriting;
+			fileChooser->launchAsync(flags, [&, directory, files = patches.getListedFiles()](const FileChooser& fc)
+			{
+				const auto result = fc.getResult();
+				if (result != File())
+				{
+					const auto bankFile = result.withFileExtension(".patchbank");
+					// a mapped file can't be replaced on every system
+					patches.closeBank(bankFile);
+					if (sta::PatchBank::create(bankFile, files) < 0)
+						juce::AlertWindow::showMessageBoxAsync(
+							juce::MessageBoxIconType::WarningIcon,
+							"Export Patch Bank",
+							"The bank couldn't be written to " + bankFile.getFullPathName() + "."
+						);
+					else if (bankFile.isAChildOf(directory))
+						scanPatches();
+				}
+				fileChooser.reset(nullptr);
+			});
+		}
+
+		void importBank()
+		{
+			const auto directory = getDirectory(utils.getProps());
+			fileChooser = std::make_unique<FileChooser>(
+				"Import Patch Bank",
+				directory,
+				"*.patchbank"
+			);
+
+			using Flag = juce::FileBrowserComponent::FileChooserFlags;
+			const auto flags = Flag::openMode
+				+ Flag::canSelectFiles;
+			fileChooser->launchAsync(flags, [&, directory](const FileChooser& fc)
+			{
+				sta::PatchBank bank;
+				if (bank.open(fc.getResult()) && bank.extract(directory) != 0)
+					scanPatches();
+				fileChooser.reset(nullptr);
+			});
+		}
+
+		void timerCallback() override
+		{
+			const auto scanning = index.isScanning();
+
+			indexed.clear();
+			if (index.pull(indexed, PatchesPerCallback))
+				patches.add(indexed);
+
+			if (!scanning)
+			{
+				patches.endRescan();
+				stopTimer();
+			}
+		}
+
 		void savePatch()
 		{
 			const auto& name = searchBar.getText();
@@ -816,23 +1162,6 @@ namespace gui
 
 			patches.applyFilters(str);
 		}
-
-		void loadPatchesFromDisk(const File& directory)
-		{
-			const auto fileTypes = File::TypesOfFileToFind::findFiles;
-			const String extension(".patch");
-			const auto wildCard = "*" + extension;
-			const RangedDirectoryIterator files
-			(
-				directory,
-				true,
-				wildCard,
-				fileTypes
-			);
-			
-			for (const auto& it : files)
-				patches.add(it.getFile());
-		}
 	};
 
 
@@ -1,7 +1,7 @@
 #include "Shader.h"
 
 gui::Shader::Shader(Utils& u, Component& _comp) :
-    Timer(),
+    FrameTimer(u.frames, &_comp),
     comp(_comp),
     utils(u),
     notify(u.getEventSystem()),
@@ -6,7 +6,7 @@ namespace gui
 {
     struct Shader :
         juce::ImageEffectFilter,
-        Timer
+        FrameTimer
     {
         Shader(Utils&, Component&);
 
@@ -2,6 +2,7 @@
 #include "Comp.h"
 #include "../audio/SpectroBeam.h"
 #include "../audio/XenManager.h"
+#include "../audio/FastMath.h"
 #include "../arch/Interpolation.h"
 #include "../arch/Conversion.h"
 #include <array>
@@ -11,26 +12,45 @@ namespace gui
 	template<size_t Order>
 	struct SpectroBeamComp :
 		public Comp,
-		public Timer
+		public FrameTimer
 	{
 		using SpecBeam = audio::SpectroBeam<Order>;
 		static constexpr int Size = SpecBeam::Size;
+		static constexpr int NumPoints = static_cast<int>(SpecBeam::NumPoints);
 		static constexpr float SizeF = static_cast<float>(Size);
 		static constexpr float SizeInv = 1.f / SizeF;
 		static constexpr float SizeFHalf = SizeF * .5f;
+		// display range and resolution of the colour gradient
+		static constexpr int LUTSize = 256;
+		static constexpr float LowestDb = -60.f;
+		static constexpr float HighestDb = 0.f;
+		static constexpr float RangeDbInv = 1.f / (HighestDb - LowestDb);
+		static constexpr float LowestGain = 1e-3f;
+		// 20 * log10(2), so that decibels come from the faster log2
+		static constexpr float DbPerLog2 = 6.02059991f;
 
 		SpectroBeamComp(Utils& u, SpecBeam& _beam) :
 			Comp(u, "Spectro Beam", CursorType::Default),
+			FrameTimer(u.frames, this),
 			mainColCID(ColourID::Hover),
-			xen(u.audioProcessor.xenManager),
 			beam(_beam),
-			img(Image::RGB, Size, 1, true)
+			interest(_beam.interest),
+			img(Image::RGB, NumPoints, 1, true),
+			lut(),
+			lutIdx(),
+			lutColBase(),
+			lutCol()
 		{
 			setInterceptsMouseClicks(false, false);
 			startTimerHz(60);
 			setOpaque(true);
 		}
 
+		void visibilityChanged() override
+		{
+			interest.setActive(isVisible());
+		}
+
 		void paint(Graphics& g) override
 		{
 			g.setImageResamplingQuality(Graphics::lowResamplingQuality);
@@ -39,43 +59,64 @@ namespace gui
 
 		void timerCallback() override
 		{
-			auto ready = beam.ready.load();
-			if (!ready)
+			// the analysis thread already mapped the spectrum onto the note axis
+			if (!beam.display.update())
 				return;
 			
-			const auto Fs = static_cast<float>(utils.audioProcessor.getSampleRate());
-			const auto fsInv = 1.f / Fs;
-			const auto colBase = Colours::c(ColourID::Bg);
-			const auto col = Colours::c(mainColCID);
-			const auto buf = beam.buffer.data();
+			updateLUT();
+			const auto buf = beam.display.getReadBuffer().data();
+
+			auto idx = lutIdx.data();
+			for (auto x = 0; x < NumPoints; ++x)
+			{
+				const auto mag = std::max(buf[x], LowestGain);
+				const auto magDb = DbPerLog2 * audio::math::log2(mag);
+				const auto magMapped = std::min(std::max((magDb - LowestDb) * RangeDbInv, 0.f), 1.f);
+				idx[x] = static_cast<int>(magMapped * static_cast<float>(LUTSize - 1));
+			}
 
-			const auto lowestDb = -12.f;
-			const auto highestDb = 6.f;
-			const auto rangeDb = highestDb - lowestDb;
-			const auto rangeDbInv = 1.f / rangeDb;
-			
-			for (auto x = 0; x < Size; ++x)
 			{
-				const auto norm = static_cast<float>(x) * SizeInv;
-				const auto pitch = norm * 128.f;
-				const auto freqHz = xen.noteToFreqHzWithWrap(pitch + xen.getXen());
-				const auto binIdx = freqHz * fsInv * SizeF;
-				
-				const auto bin = interpolate::lerp(buf, binIdx);
-				const auto magDb = audio::gainToDecibel(bin);
-				const auto magMapped = juce::jlimit(0.f, 1.f, (magDb - lowestDb) * rangeDbInv);
-				const auto nCol = colBase.interpolatedWith(col, magMapped);
-				img.setPixelAt(x, 0, nCol);
+				const Image::BitmapData bitmap(img, Image::BitmapData::writeOnly);
+				auto line = bitmap.getLinePointer(0);
+				// some backends keep rgb images as argb
+				if (bitmap.pixelFormat == Image::RGB)
+					for (auto x = 0; x < NumPoints; ++x)
+						reinterpret_cast<juce::PixelRGB*>(line + x * bitmap.pixelStride)->set(lut[idx[x]]);
+				else if (bitmap.pixelFormat == Image::ARGB)
+					for (auto x = 0; x < NumPoints; ++x)
+						reinterpret_cast<juce::PixelARGB*>(line + x * bitmap.pixelStride)->set(lut[idx[x]]);
+				else
+					for (auto x = 0; x < NumPoints; ++x)
+						bitmap.setPixelColour(x, 0, Colour(lut[idx[x]]));
 			}
 			
-			beam.ready.store(false);
 			repaint();
 		}
 		
 		ColourID mainColCID;
 	protected:
-		const audio::XenManager& xen;
 		SpecBeam& beam;
+		audio::Interest::Registration interest;
 		Image img;
+		std::array<juce::PixelARGB, LUTSize> lut;
+		std::array<int, NumPoints> lutIdx;
+		Colour lutColBase, lutCol;
+
+		/* rebuilds the colour gradient if the colours changed */
+		void updateLUT()
+		{
+			const auto colBase = Colours::c(ColourID::Bg);
+			const auto col = Colours::c(mainColCID);
+			if (colBase == lutColBase && col == lutCol)
+				return;
+			lutColBase = colBase;
+			lutCol = col;
+
+			for (auto i = 0; i < LUTSize; ++i)
+			{
+				const auto x = static_cast<float>(i) / static_cast<float>(LUTSize - 1);
+				lut[i] = colBase.interpolatedWith(col, x).getPixelARGB();
+			}
+		}
 	};
 }
\ No newline at end of file
@@ -7,7 +7,7 @@ namespace gui
 {
 	struct SplineEditor :
 		public Comp,
-		public Timer
+		public FrameTimer
 	{
 		static constexpr float MinDraggerWidth = .01f;
 		static constexpr float DraggerWidthStep = .01f;
@@ -167,6 +167,7 @@ namespace gui
 
 		SplineEditor(Utils& u, const String& _tooltip) :
 			Comp(u, _tooltip, CursorType::Interact),
+			FrameTimer(u.frames, this),
 			bounds(),
 			points(),
 			curve(),
@@ -5,7 +5,7 @@ namespace gui
 
 	TextEditor::TextEditor(Utils& u, const String& _tooltip, Notify&& _notify, const String& _emptyString) :
 		Comp(u, _tooltip, std::move(_notify)),
-		Timer(),
+		FrameTimer(u.frames, this),
 		onEscape([]() { return true; }),
 		onReturn([]() { return true; }),
 		onType([]() { return true; }),
@@ -14,7 +14,7 @@ namespace gui
 
 		label(u, ""),
 		emptyString(_emptyString), txt(""),
-		blinkyBoy(),
+		blinkyBoy(u),
 		tickIdx(0),
 		drawTick(false),
 		multiLine(true)
@@ -27,7 +27,7 @@ namespace gui
 
 	TextEditor::TextEditor(Utils& u, const String& _tooltip, const String& _emptyString) :
 		Comp(u, _tooltip),
-		Timer(),
+		FrameTimer(u.frames, this),
 		onEscape([]() { return true; }),
 		onReturn([]() { return true; }),
 		onType([]() { return true; }),
@@ -36,7 +36,7 @@ namespace gui
 
 		label(u, ""),
 		emptyString(_emptyString), txt(""),
-		blinkyBoy(),
+		blinkyBoy(u),
 		tickIdx(0),
 		drawTick(false),
 		multiLine(false)
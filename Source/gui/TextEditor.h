@@ -6,7 +6,7 @@ namespace gui
 {
 	struct TextEditor :
 		public Comp,
-		public Timer
+		public FrameTimer
 	{
 		/* tooltip, empty string */
 		TextEditor(Utils&, const String&, Notify&&, const String& = "enter value..");
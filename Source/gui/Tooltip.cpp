@@ -1,10 +1,11 @@
 #include "Tooltip.h"
+#include "../arch/Dispatch.h"
 
 namespace gui
 {
 	Tooltip::Tooltip(Utils& _utils, String&& _tooltip) :
 		Comp(_utils, _tooltip, makeNotify(this), CursorType::Default),
-		buildDateLabel(utils, static_cast<String>(JucePlugin_Manufacturer) + " Plugins, v: " + static_cast<String>(__DATE__) + " " + static_cast<String>(__TIME__)),
+		buildDateLabel(utils, static_cast<String>(JucePlugin_Manufacturer) + " Plugins, v: " + static_cast<String>(__DATE__) + " " + static_cast<String>(__TIME__) + ", " + dispatch::toString(dispatch::get().isa)),
 		tooltipLabel(utils, "")
 	{
 		layout.init
@@ -6,6 +6,7 @@ namespace gui
 	Utils::Utils(Component& _pluginTop, Processor& _audioProcessor) :
 		pluginTop(_pluginTop),
 		audioProcessor(_audioProcessor),
+		frames(_pluginTop),
 		params(audioProcessor.params),
 		eventSystem(),
 		evt(eventSystem),
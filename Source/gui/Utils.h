@@ -2,6 +2,7 @@
 #include "Using.h"
 #include "Shared.h"
 #include "Events.h"
+#include "FrameScheduler.h"
 #include "../audio/MIDILearn.h"
 
 namespace gui
@@ -81,6 +82,7 @@ namespace gui
 		Component& pluginTop;
 		float thicc;
 		Processor& audioProcessor;
+		FrameScheduler frames;
 	protected:
 		Params& params;
 		EventSystem eventSystem;
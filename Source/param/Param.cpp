@@ -265,6 +265,9 @@ namespace param
 		range(_range),
 
 		state(_state),
+		valueHandle(getIDString(pID), "value"),
+		maxModDepthHandle(getIDString(pID), "maxmoddepth"),
+		modBiasHandle(getIDString(pID), "modbias"),
 		valDenormDefault(_valDenormDefault),
 
 		valNorm(range.convertTo0to1(_valDenormDefault)),
@@ -278,27 +281,28 @@ namespace param
 
 		locked(false),
 		inGesture(false),
+		// starts at 1, so an observer starting at 0 always looks once
+		generation(1),
 
 		modDepthLocked(false)
 	{
 	}
 
-	void Param::savePatch(juce::ApplicationProperties& appProps) const
+	void Param::savePatch() const
 	{
-		const auto idStr = getIDString(id);
-
 		const auto v = range.convertFrom0to1(getValue());
-		state.set(idStr, "value", v, true);
+		state.set(valueHandle, v, true);
 		const auto mdd = getMaxModDepth();
-		state.set(idStr, "maxmoddepth", mdd, true);
+		state.set(maxModDepthHandle, mdd, true);
 		const auto mb = getModBias();
-		state.set(idStr, "modbias", mb, true);
+		state.set(modBiasHandle, mb, true);
+	}
 
+	void Param::saveDefaultValue(juce::ApplicationProperties& appProps) const
+	{
 		auto user = appProps.getUserSettings();
 		if (user->isValidFile())
-		{
-			user->setValue(idStr + "valDefault", valDenormDefault);
-		}
+			user->setValue(getIDString(id) + "valDefault", valDenormDefault);
 	}
 
 	void Param::loadPatch(juce::ApplicationProperties& appProps)
@@ -308,7 +312,7 @@ namespace param
 		const auto lckd = isLocked();
 		if (!lckd)
 		{
-			auto var = state.get(idStr, "value");
+			auto var = state.get(valueHandle);
 			if (var)
 			{
 				const auto val = static_cast<float>(*var);
@@ -316,13 +320,13 @@ namespace param
 				const auto valD = range.convertTo0to1(legalVal);
 				setValueNotifyingHost(valD);
 			}
-			var = state.get(idStr, "maxmoddepth");
+			var = state.get(maxModDepthHandle);
 			if (var)
 			{
 				const auto val = static_cast<float>(*var);
 				setMaxModDepth(val);
 			}
-			var = state.get(idStr, "modbias");
+			var = state.get(modBiasHandle);
 			if (var)
 			{
 				const auto val = static_cast<float>(*var);
@@ -354,9 +358,14 @@ namespace param
 	{
 		if (isLocked())
 			return;
+		state.markDirty();
 
 		if (!modDepthLocked)
-			return valNorm.store(normalized);
+		{
+			valNorm.store(normalized);
+			nextGeneration();
+			return;
+		}
 
 		const auto p0 = valNorm.load();
 		const auto p1 = normalized;
@@ -406,6 +415,8 @@ namespace param
 			return;
 
 		maxModDepth.store(juce::jlimit(-1.f, 1.f, v));
+		nextGeneration();
+		state.markDirty();
 	}
 
 	float Param::calcValModOf(float macro) const noexcept
@@ -438,6 +449,8 @@ namespace param
 
 		b = juce::jlimit(BiasEps, 1.f - BiasEps, b);
 		modBias.store(b);
+		nextGeneration();
+		state.markDirty();
 	}
 
 	float Param::getModBias() const noexcept
@@ -448,6 +461,7 @@ namespace param
 	void Param::setModDepthLocked(bool e) noexcept
 	{
 		modDepthLocked = e;
+		state.markDirty();
 	}
 
 	void Param::setDefaultValue(float norm) noexcept
@@ -458,7 +472,12 @@ namespace param
 	// called by processor to update modulation value(s)
 	void Param::modulate(float macro) noexcept
 	{
-		valMod.store(calcValModOf(macro));
+		// runs every block, but only actual changes count
+		const auto vm = calcValModOf(macro);
+		if (valMod.load() == vm)
+			return;
+		valMod.store(vm);
+		nextGeneration();
 	}
 
 	float Param::getDefaultValue() const
@@ -521,6 +540,7 @@ namespace param
 	void Param::setLocked(bool e) noexcept
 	{
 		locked.store(e);
+		nextGeneration();
 	}
 
 	void Param::switchLock() noexcept
@@ -533,6 +553,16 @@ namespace param
 		return "params/" + toID(toString(pID));
 	}
 
+	unsigned int Param::getGeneration() const noexcept
+	{
+		return generation.load();
+	}
+
+	void Param::nextGeneration() noexcept
+	{
+		generation.fetch_add(1);
+	}
+
 	float Param::biased(float start, float end, float bias/*[0,1]*/, float x) const noexcept
 	{
 		const auto r = end - start;
@@ -1175,6 +1205,7 @@ namespace param
 	Params::Params(AudioProcessor& audioProcessor, State& _state, const Xen& xen) :
 		params(),
 		state(_state),
+		modDepthLockedHandle(getIDString(), "moddepthlocked"),
 		modDepthLocked(false)
 	{
 		{ // HIGH LEVEL PARAMS:
@@ -1271,12 +1302,14 @@ namespace param
 
 		for (auto param : params)
 			audioProcessor.addParameter(param);
+
+		// what Param::savePatch writes, stored as a table in the binary chunk
+		state.setPackedTable(getIDString(), { "value", "maxmoddepth", "modbias" });
 	}
 
 	void Params::loadPatch(juce::ApplicationProperties& appProps)
 	{
-		const auto idStr = getIDString();
-		const auto mdl = state.get(idStr, "moddepthlocked");
+		const auto mdl = state.get(modDepthLockedHandle);
 		if (mdl != nullptr)
 			setModDepthLocked(static_cast<int>(*mdl) != 0);
 
@@ -1284,13 +1317,12 @@ namespace param
 			param->loadPatch(appProps);
 	}
 
-	void Params::savePatch(juce::ApplicationProperties& appProps) const
+	void Params::savePatch() const
 	{
 		for (auto param : params)
-			param->savePatch(appProps);
+			param->savePatch();
 
-		const auto idStr = getIDString();
-		state.set(idStr, "moddepthlocked", isModDepthLocked() ? 1 : 0);
+		state.set(modDepthLockedHandle, isModDepthLocked() ? 1 : 0);
 	}
 
 	String Params::getIDString()
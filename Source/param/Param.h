@@ -169,10 +169,13 @@ namespace param
 			const ValToStrFunc&, const StrToValFunc&,
 			State&, const Unit = Unit::NumUnits);
 
-		void savePatch(juce::ApplicationProperties&) const;
+		void savePatch() const;
 
 		void loadPatch(juce::ApplicationProperties&);
 
+		/* appProps. stores the default value in the user settings. only called when the user changes it */
+		void saveDefaultValue(juce::ApplicationProperties&) const;
+
 		//called by host, normalized, thread-safe
 		float getValue() const override;
 
@@ -240,10 +243,14 @@ namespace param
 
 		static String getIDString(PID);
 
+		/* counts the changes of value, modulation and lock. lets the editor skip parameters that didn't change */
+		unsigned int getGeneration() const noexcept;
+
 		const PID id;
 		const Range range;
 	protected:
 		State& state;
+		State::Handle valueHandle, maxModDepthHandle, modBiasHandle;
 		float valDenormDefault;
 		std::atomic<float> valNorm, maxModDepth, valMod, modBias;
 		ValToStrFunc valToStr;
@@ -251,8 +258,11 @@ namespace param
 		Unit unit;
 
 		std::atomic<bool> locked, inGesture;
+		std::atomic<unsigned int> generation;
 
 		bool modDepthLocked;
+
+		void nextGeneration() noexcept;
 	};
 
 	struct Params
@@ -264,7 +274,7 @@ namespace param
 
 		void loadPatch(juce::ApplicationProperties&);
 
-		void savePatch(juce::ApplicationProperties&) const;
+		void savePatch() const;
 
 		static String getIDString();
 
@@ -287,6 +297,7 @@ namespace param
 		Parameters params;
 
 		State& state;
+		State::Handle modDepthLockedHandle;
 		std::atomic<float> modDepthLocked;
 	};
 